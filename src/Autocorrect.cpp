@@ -48,7 +48,7 @@ string Autocorrect::chooseBest(const string &orig, const vector<string> &cands)
 }
 
 // Use the shared Tokenizer for tokenization
-// (Tokenizer is defined in Tokenizer.h and is constructed where needed)
+// (one Tokenizer and scratch buffer per Autocorrect instance, see autocorrectLine)
 
 // Correct single word using trie suggestions and internal frequency table
 string Autocorrect::correctWord(const string &w) const {
@@ -191,8 +191,8 @@ static string rebuildFromTokens(const vector<Token> &tokens){
 }
 
 string Autocorrect::autocorrectLine(const string &line, vector<string> &issues, size_t /*lineNo*/){
-	Tokenizer tk;
-	auto tokens = tk.tokenize(line);
+	tokenizer_.tokenize(line, tokens_);
+	auto &tokens = tokens_;
 	for (auto &t : tokens){
 		if (t.type==TokType::IDENTIFIER || t.type==TokType::KEYWORD){
 			string corrected = correctWord(t.value);
@@ -34,6 +34,8 @@ private:
     SymbolTable &sym_;
     Logger &log_;
     std::unordered_map<std::string,int> freq_; // higher = more common
+    Tokenizer tokenizer_;
+    std::vector<Token> tokens_; // scratch token buffer reused across autocorrectLine calls
 
     // Levenshtein distance DP (classic)
     static int editDistance(const std::string &a, const std::string &b);
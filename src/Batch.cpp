@@ -0,0 +1,223 @@
+#include "Batch.h"
+#include "ThreadPool.h"
+#include "SymbolTable.h"
+#include "Logger.h"
+#include "Utils.h"
+#include "DiffWriter.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <set>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+static bool isSourceFile(const fs::path &p){
+    static const std::set<std::string> exts = {".c", ".cc", ".cpp", ".cxx", ".h", ".hh", ".hpp", ".hxx"};
+    if (!exts.count(p.extension().string())) return false;
+    return p.filename().string().rfind("corrected_", 0) != 0;
+}
+
+BatchRunner::BatchRunner(Trie &trie) : trie_(trie) {}
+
+void BatchRunner::setCacheDir(const std::string &dir, uint64_t maxBytes){
+    if (dir.empty()) cache_.reset();
+    else cache_ = std::make_unique<ResultCache>(dir, maxBytes);
+}
+
+BatchRunner::ConfigKey BatchRunner::configKey() const {
+    ConfigKey k{ResultCache::hash(""), ResultCache::checksum("")};
+    auto add = [&k](std::string_view part){
+        k.key = ResultCache::hash(part, k.key);
+        k.check = ResultCache::checksum(part, k.check);
+    };
+    add(Analyzer::rulesVersion());
+    for (const auto &w : trie_.allWords()){
+        add(w);
+        add("\n");
+    }
+    add(passes_);
+    add(harvest_ ? "harvest" : "one-pass");
+    add(countOnly_ ? "count" : "full");
+    return k;
+}
+
+// Same line split as std::getline: a final '\n' does not start another line
+static void splitLines(const std::string &text, std::vector<std::string> &lines){
+    size_t start = 0;
+    while (start < text.size()){
+        size_t nl = text.find('\n', start);
+        if (nl == std::string::npos) nl = text.size();
+        lines.emplace_back(text, start, nl - start);
+        start = nl + 1;
+    }
+}
+
+std::vector<std::string> BatchRunner::collect(const std::vector<std::string> &paths, std::vector<std::string> *errors){
+    std::set<std::string> files;
+    for (const auto &p : paths){
+        std::error_code ec;
+        if (fs::is_directory(p, ec)){
+            for (fs::recursive_directory_iterator it(p, fs::directory_options::skip_permission_denied, ec), end; !ec && it != end; it.increment(ec)){
+                if (it->is_regular_file(ec) && isSourceFile(it->path())) files.insert(it->path().lexically_normal().string());
+            }
+            if (ec && errors) errors->push_back(p + ": " + ec.message());
+        } else if (fs::is_regular_file(p, ec)){
+            files.insert(fs::path(p).lexically_normal().string()); // explicit files are taken as given
+        } else if (errors){
+            errors->push_back(p + ": not found");
+        }
+    }
+    return std::vector<std::string>(files.begin(), files.end());
+}
+
+std::string BatchRunner::outputPath(const std::string &input) const {
+    fs::path in(input);
+    std::string name = "corrected_" + in.filename().string();
+    if (outDir_.empty()) return (in.parent_path() / name).string();
+    // Mirror the input's relative location so same-named files do not collide;
+    // root and '..' parts are dropped so the copy cannot land outside outDir_
+    fs::path rel;
+    for (const auto &part : in.lexically_normal().relative_path().parent_path()){
+        if (part != ".." && part != ".") rel /= part;
+    }
+    fs::path dir = fs::path(outDir_).lexically_normal();
+    fs::path out = (dir / rel / name).lexically_normal();
+    fs::path back = out.lexically_relative(dir);
+    if (back.empty() || *back.begin() == "..") return std::string();
+    return out.string();
+}
+
+std::vector<BatchFileResult> BatchRunner::run(const std::vector<std::string> &files){
+    std::vector<BatchFileResult> results(files.size());
+    if (files.empty()) return results;
+
+    // Load the shared dictionary once, before any worker reads it
+    if (trie_.allWords().empty()) trie_.loadDefaultDictionary();
+    const ConfigKey config = cache_ && !checkMax_ ? configKey() : ConfigKey();
+
+    WorkStealingPool pool((unsigned)std::min<size_t>(threads_ ? threads_ : std::max(1u, std::thread::hardware_concurrency()), files.size()));
+
+    // Per-worker state; Logger is never init()ed, so it discards per-line logging
+    struct Worker {
+        SymbolTable sym;
+        Logger log;
+        std::unique_ptr<Analyzer> analyzer;
+    };
+    std::vector<Worker> workers(pool.size());
+    for (auto &w : workers){
+        w.analyzer = std::make_unique<Analyzer>(trie_, w.sym, w.log);
+        // Parallelism is across files; a single file gets the threads itself
+        w.analyzer->setThreads(files.size() == 1 ? threads_ : 1);
+        w.analyzer->setFormatIssues(false);
+        w.analyzer->setHarvestDeclarations(harvest_);
+        if (!passes_.empty()) w.analyzer->configurePasses(passes_);
+    }
+
+    for (size_t i=0; i<files.size(); ++i){
+        pool.submit([this, &files, &results, &workers, config, i](unsigned wi){
+            BatchFileResult &r = results[i];
+            r.input = files[i];
+            std::ifstream in(files[i]);
+            if (!in.is_open()){ r.error = "cannot read"; return; }
+            std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            std::vector<std::string> lines;
+            splitLines(text, lines);
+            r.lines = lines.size();
+
+            if (checkMax_){
+                Analyzer &an = *workers[wi].analyzer;
+                std::vector<Issue> records;
+                r.issueCount = an.checkFile(lines, checkMax_, &records);
+                if (!countOnly_){
+                    for (auto &issue : records){
+                        r.issues.push_back(issue.line ? "line " + std::to_string(issue.line) + ": " + an.formatIssue(issue) : an.formatIssue(issue));
+                    }
+                }
+                r.checked = true;
+                r.ok = true;
+                return;
+            }
+
+            // Unchanged content under the same dictionary and passes: reuse the last result
+            ResultCache::Entry entry;
+            uint64_t key = cache_ ? ResultCache::hash(text, config.key) : 0;
+            ResultCache::Source src{text.size(), cache_ ? ResultCache::checksum(text, config.check) : 0};
+            if (cache_ && cache_->lookup(key, src, entry)){
+                r.cached = true;
+            } else {
+                Analyzer &an = *workers[wi].analyzer;
+                std::vector<std::string> fileIssues; // stays empty: end-of-file issues are records too
+                std::vector<Issue> records;
+                an.setIssueSink(&records);
+                entry.fixed = an.processFile(lines, fileIssues);
+                an.setIssueSink(nullptr);
+                entry.issueCount = records.size();
+                if (!countOnly_){
+                    entry.issues.reserve(entry.issueCount);
+                    for (auto &issue : records){
+                        entry.issues.push_back(issue.line ? "line " + std::to_string(issue.line) + ": " + an.formatIssue(issue) : an.formatIssue(issue));
+                    }
+                }
+                for (size_t k=0; k<lines.size() && k<entry.fixed.size(); ++k) if (entry.fixed[k] != lines[k]) ++entry.changedLines;
+                if (cache_) cache_->store(key, src, entry);
+            }
+            r.issueCount = entry.issueCount;
+            r.issues = std::move(entry.issues);
+            r.changedLines = entry.changedLines;
+            const auto &fixed = entry.fixed;
+
+            if (diffOutput_){
+                std::ostringstream diff;
+                DiffWriter::write(diff, files[i], files[i], lines, fixed, 3, text.empty() || text.back() == '\n');
+                r.diff = diff.str();
+                r.ok = true;
+                return;
+            }
+
+            std::string outPath = outputPath(files[i]);
+            if (outPath.empty()){ r.error = "output path outside " + outDir_; return; }
+            std::error_code ec;
+            fs::path parent = fs::path(outPath).parent_path();
+            if (!parent.empty()) fs::create_directories(parent, ec);
+            std::ofstream out(outPath);
+            if (!out.is_open()){ r.error = "cannot write " + outPath; return; }
+            for (auto &l : fixed) out << l << "\n";
+            r.output = outPath;
+            r.ok = true;
+        });
+    }
+    pool.wait();
+    if (cache_) cache_->evict();
+    return results;
+}
+
+std::vector<std::string> BatchRunner::formatReport(const std::vector<BatchFileResult> &results){
+    std::vector<std::string> report;
+    size_t ok = 0, changed = 0, issues = 0, cached = 0;
+    for (const auto &r : results){
+        if (r.ok) ++ok;
+        if (r.cached) ++cached;
+        if (r.changedLines) ++changed;
+        issues += r.issueCount;
+    }
+    report.push_back("Batch report: " + std::to_string(results.size()) + " files, " + std::to_string(ok) + " written, "
+                     + std::to_string(changed) + " changed, " + std::to_string(issues) + " issues"
+                     + (cached ? ", " + std::to_string(cached) + " from cache" : std::string()));
+    for (const auto &r : results){
+        std::string head = "== " + r.input;
+        if (!r.ok) head += " (failed: " + r.error + ")";
+        else if (r.checked) head += r.issueCount ? " (needs fixes)" : " (clean)";
+        else head += " -> " + (r.output.empty() ? std::string("diff") : r.output) + " (" + std::to_string(r.changedLines) + "/" + std::to_string(r.lines) + " lines changed)";
+        if (r.cached) head += " [cached]";
+        report.push_back(head);
+        for (const auto &msg : r.issues) report.push_back("  - " + msg);
+    }
+    return report;
+}
+
+void BatchRunner::writePatch(std::ostream &out, const std::vector<BatchFileResult> &results){
+    for (const auto &r : results) out << r.diff;
+}
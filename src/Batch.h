@@ -0,0 +1,76 @@
+#pragma once
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Trie.h"
+#include "ResultCache.h"
+
+// Result of fixing one file in batch mode
+struct BatchFileResult {
+    std::string input;
+    std::string output;                  // corrected_<name>; empty if not written
+    std::string diff;                    // unified diff of the fixes (diff output mode)
+    std::vector<std::string> issues;     // "line N: ..." then end-of-file issues (empty in count-only mode)
+    size_t issueCount = 0;
+    size_t lines = 0;
+    size_t changedLines = 0;
+    bool ok = false;                     // read and written successfully
+    bool cached = false;                 // answered from the result cache
+    bool checked = false;                // check mode: issues found, nothing written
+    std::string error;
+};
+
+// Fixes many files at once. Files are spread over a work-stealing pool; each
+// worker owns its own Analyzer (symbol table, brace state, rule scratch) while
+// all of them share one read-only dictionary trie. Results always come back in
+// sorted path order, whatever order the workers finished in.
+class BatchRunner {
+public:
+    explicit BatchRunner(Trie &trie);
+
+    void setThreads(unsigned n) { threads_ = n; }           // 0 = one per hardware thread
+    void setOutputDir(const std::string &dir) { outDir_ = dir; } // empty = next to each input
+    void setPasses(const std::string &spec) { passes_ = spec; }
+    // Two-pass files (Analyzer::setHarvestDeclarations)
+    void setHarvestDeclarations(bool on) { harvest_ = on; }
+    // Count issues without formatting any message text
+    void setCountOnly(bool on) { countOnly_ = on; }
+    // Keep only a unified diff per file (see writePatch) instead of writing corrected_* copies
+    void setDiffOutput(bool on) { diffOutput_ = on; }
+    // Check mode: stop each file after maxIssues issues and write nothing (0 = off)
+    void setCheckOnly(size_t maxIssues) { checkMax_ = maxIssues; }
+    // Reuse results of unchanged files across runs (empty dir = no cache)
+    void setCacheDir(const std::string &dir, uint64_t maxBytes = ResultCache::kDefaultMaxBytes);
+    const ResultCache *cache() const { return cache_.get(); }
+
+    // Expand files and directories (recursively, C/C++ sources and headers only)
+    // into a sorted, de-duplicated file list. Previous corrected_* outputs are skipped.
+    static std::vector<std::string> collect(const std::vector<std::string> &paths, std::vector<std::string> *errors = nullptr);
+
+    std::vector<BatchFileResult> run(const std::vector<std::string> &files);
+
+    // Merged report: one section per file, in the order run() returned them
+    static std::vector<std::string> formatReport(const std::vector<BatchFileResult> &results);
+    // Concatenated diffs of all results, in order: one patch for the whole run (patch -p0)
+    static void writePatch(std::ostream &out, const std::vector<BatchFileResult> &results);
+
+private:
+    Trie &trie_;
+    unsigned threads_ = 0;
+    std::string outDir_;
+    std::string passes_;
+    bool countOnly_ = false;
+    bool harvest_ = false;
+    bool diffOutput_ = false;
+    size_t checkMax_ = 0;
+    std::unique_ptr<ResultCache> cache_;
+
+    // Where the corrected copy goes; empty if it would fall outside outDir_
+    std::string outputPath(const std::string &input) const;
+    // Cache seeds: the rules build, dictionary contents and everything else that
+    // changes the output, chained through hash() for the key and checksum() for
+    // the entry's check
+    struct ConfigKey { uint64_t key = 0, check = 0; };
+    ConfigKey configKey() const;
+};
@@ -0,0 +1,412 @@
+#include "Cli.h"
+#include <csignal>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include "Batch.h"
+#include "Daemon.h"
+#include "FastIO.h"
+#include "Logger.h"
+#include "LspServer.h"
+#include "SymbolTable.h"
+#include "Trie.h"
+#include "Utils.h"
+
+namespace fs = std::filesystem;
+
+std::string cliUsage(){
+    return
+        "usage: intellifix [options] <files/dirs...>\n"
+        "       intellifix            (interactive menu)\n"
+        "\n"
+        "Fixes C/C++ sources without prompting; directories are searched recursively.\n"
+        "\n"
+        "  -o, --out DIR        write corrected_* copies (under each input's path) or\n"
+        "                       batch.patch to DIR (default: copies next to each input,\n"
+        "                       patch to stdout)\n"
+        "  -l, --log DIR        write logs to DIR: for files, only the batch report\n"
+        "                       (batch_report.txt, also in analysis.txt); per-line\n"
+        "                       fixes go to fixes.log in filter mode only\n"
+        "  -j, --threads N      worker threads (default: one per hardware thread)\n"
+        "  -d, --diff           write one unified diff instead of corrected copies\n"
+        "  -c, --check          only report issues; exit 1 if any file needs fixes\n"
+        "      --max-issues N   check mode: stop each file after N issues (default 1)\n"
+        "      --passes SPEC    enable/disable fix passes (e.g. fixForLoop=off,-fixIdentifiers)\n"
+        "      --harvest        collect every name a file declares before fixing it, so\n"
+        "                       no declared name is corrected (files and --serve only)\n"
+        "      --count-only     count issues without formatting messages\n"
+        "      --cache DIR      reuse results of unchanged files across runs\n"
+        "  -f, --filter, -      read stdin, write the fixed source to stdout as it goes\n"
+        "      --issues-fd N    filter mode: write issues to fd N (default 2, stderr)\n"
+        "      --stdin-name N   filter mode: file name shown in issues (default <stdin>)\n"
+        "      --serve SOCKET   run as a daemon on a Unix socket, dictionary kept warm\n"
+        "      --connect SOCKET send the input file (or stdin) to a running daemon\n"
+        "      --range A:B      with --connect: return only lines A..B\n"
+        "      --ping, --stats, --shutdown\n"
+        "                       with --connect: query or stop the daemon\n"
+        "      --lsp            run as a language server on stdin/stdout\n"
+        "  -q, --quiet          do not print issues, only the summary\n"
+        "  -i, --interactive    start the interactive menu\n"
+        "  -h, --help           show this help\n";
+}
+
+static bool parseCount(const std::string &text, unsigned long long &value){
+    if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos) return false;
+    value = std::strtoull(text.c_str(), nullptr, 10);
+    return true;
+}
+
+bool parseCliArgs(const std::vector<std::string> &args, CliOptions &opts, std::string &error){
+    bool optionsDone = false;
+    for (size_t i=0; i<args.size(); ++i){
+        std::string a = args[i];
+        if (optionsDone || a.size() < 2 || a[0] != '-'){
+            if (a == "-") opts.filter = true;
+            else opts.inputs.push_back(a);
+            continue;
+        }
+        if (a == "--"){ optionsDone = true; continue; }
+
+        // --name=value is the same as --name value
+        std::string inlineValue;
+        bool hasInline = false;
+        size_t eq = a.find('=');
+        if (a.compare(0, 2, "--") == 0 && eq != std::string::npos){
+            inlineValue = a.substr(eq + 1);
+            a.resize(eq);
+            hasInline = true;
+        }
+        auto value = [&](std::string &dst){
+            if (hasInline){ dst = inlineValue; return true; }
+            if (i + 1 >= args.size()){ error = "missing value for " + a; return false; }
+            dst = args[++i];
+            return true;
+        };
+        auto count = [&](unsigned long long &dst){
+            std::string text;
+            if (!value(text)) return false;
+            if (!parseCount(text, dst)){ error = "expected a number for " + a + ": " + text; return false; }
+            return true;
+        };
+
+        unsigned long long n = 0;
+        if (a == "-o" || a == "--out"){ if (!value(opts.outDir)) return false; }
+        else if (a == "-l" || a == "--log"){ if (!value(opts.logDir)) return false; }
+        else if (a == "--cache"){ if (!value(opts.cacheDir)) return false; }
+        else if (a == "--passes"){ if (!value(opts.passes)) return false; }
+        else if (a == "-j" || a == "--threads"){ if (!count(n)) return false; opts.threads = (unsigned)n; }
+        else if (a == "--stdin-name"){ if (!value(opts.stdinName)) return false; }
+        else if (a == "--issues-fd"){
+            if (!count(n)) return false;
+            opts.issuesFd = (int)n;
+        }
+        else if (a == "--serve"){ if (!value(opts.serveSocket)) return false; }
+        else if (a == "--connect"){ if (!value(opts.connectSocket)) return false; }
+        else if (a == "--range"){
+            std::string text;
+            if (!value(text)) return false;
+            unsigned long long first = 0, last = 0;
+            size_t colon = text.find(':');
+            if (colon == std::string::npos || !parseCount(text.substr(0, colon), first) || !parseCount(text.substr(colon + 1), last)
+                || first == 0 || last < first){
+                error = "--range expects FIRST:LAST (1-based, inclusive): " + text;
+                return false;
+            }
+            opts.clientCommand = "RANGE";
+            opts.rangeFirst = (size_t)first;
+            opts.rangeLast = (size_t)last;
+        }
+        else if (a == "--max-issues"){
+            if (!count(n)) return false;
+            if (n == 0){ error = "--max-issues must be at least 1"; return false; }
+            opts.maxIssues = (size_t)n;
+        }
+        else if (hasInline){ error = "option takes no value: " + a; return false; }
+        else if (a == "-d" || a == "--diff") opts.diff = true;
+        else if (a == "-c" || a == "--check") opts.check = true;
+        else if (a == "--count-only") opts.countOnly = true;
+        else if (a == "--harvest") opts.harvest = true;
+        else if (a == "-q" || a == "--quiet") opts.quiet = true;
+        else if (a == "-f" || a == "--filter") opts.filter = true;
+        else if (a == "-i" || a == "--interactive") opts.interactive = true;
+        else if (a == "-h" || a == "--help") opts.help = true;
+        else if (a == "--ping") opts.clientCommand = "PING";
+        else if (a == "--stats") opts.clientCommand = "STATS";
+        else if (a == "--shutdown") opts.clientCommand = "SHUTDOWN";
+        else if (a == "--lsp") opts.lsp = true;
+        else { error = "unknown option: " + a; return false; }
+    }
+    if (opts.help || opts.interactive) return true;
+    if (opts.clientCommand != "FIX" && opts.connectSocket.empty()){ error = "--range, --ping, --stats and --shutdown need --connect"; return false; }
+    if (opts.harvest && (opts.lsp || opts.filter || !opts.connectSocket.empty())){
+        error = "--harvest needs whole files: use it with file inputs or --serve";
+        return false;
+    }
+    if (opts.lsp){
+        if (!opts.serveSocket.empty() || !opts.connectSocket.empty() || !opts.inputs.empty() || opts.filter){
+            error = "--lsp takes no inputs";
+            return false;
+        }
+        return true;
+    }
+    if (!opts.serveSocket.empty()){
+        if (!opts.connectSocket.empty() || !opts.inputs.empty() || opts.filter){ error = "--serve takes no inputs"; return false; }
+        return true;
+    }
+    if (!opts.connectSocket.empty()){
+        if (opts.inputs.size() > 1){ error = "--connect sends one file (or stdin)"; return false; }
+        return true;
+    }
+    if (opts.filter){
+        if (!opts.inputs.empty()){ error = "filter mode reads stdin only; drop the file arguments"; return false; }
+        if (opts.check || opts.diff || !opts.outDir.empty() || !opts.cacheDir.empty()){
+            error = "filter mode cannot be combined with --check, --diff, --out or --cache";
+            return false;
+        }
+        return true;
+    }
+    if (opts.inputs.empty()){ error = "no input files or directories"; return false; }
+    if (opts.check && opts.diff){ error = "--check and --diff cannot be combined"; return false; }
+    return true;
+}
+
+std::string defaultLogDir(){
+    const char *home = nullptr;
+    fs::path base;
+#ifdef _WIN32
+    if ((home = std::getenv("USERPROFILE"))) base = fs::path(home) / "Documents" / "IntelliFixPP";
+#else
+    const char *state = std::getenv("XDG_STATE_HOME");
+    if (state && *state) base = fs::path(state) / "intellifix";
+    else if ((home = std::getenv("HOME")) && *home) base = fs::path(home) / ".local" / "state" / "intellifix";
+#endif
+    if (base.empty()) base = fs::current_path();
+    return (base / "output").string();
+}
+
+static bool writeAllLines(const std::string &path, const std::vector<std::string> &lines){
+    std::ofstream out(path);
+    if (!out.is_open()) return false;
+    for (auto &l : lines) out << l << "\n";
+    return bool(out);
+}
+
+int runCli(const CliOptions &opts, std::ostream &out, std::ostream &err){
+    std::vector<std::string> errors;
+    auto files = BatchRunner::collect(opts.inputs, &errors);
+    for (auto &e : errors) err << e << "\n";
+    if (files.empty()){
+        err << "no source files found" << std::endl;
+        return 2;
+    }
+
+    Trie trie;
+    if (!opts.passes.empty()){
+        // Reject a bad spec up front rather than once per worker
+        SymbolTable sym; Logger log;
+        Analyzer probe(trie, sym, log);
+        std::string passError;
+        if (!probe.configurePasses(opts.passes, &passError)){
+            err << "--passes: " << passError << std::endl;
+            return 2;
+        }
+    }
+
+    if (!opts.outDir.empty() && !opts.check){
+        std::error_code ec;
+        fs::create_directories(opts.outDir, ec);
+        if (ec){ err << opts.outDir << ": " << ec.message() << std::endl; return 2; }
+    }
+
+    BatchRunner batch(trie);
+    batch.setThreads(opts.threads);
+    batch.setPasses(opts.passes);
+    batch.setHarvestDeclarations(opts.harvest);
+    batch.setCountOnly(opts.countOnly);
+    batch.setDiffOutput(opts.diff);
+    if (opts.check) batch.setCheckOnly(opts.maxIssues);
+    else if (!opts.diff) batch.setOutputDir(opts.outDir);
+    if (!opts.cacheDir.empty()) batch.setCacheDir(opts.cacheDir);
+    auto results = batch.run(files);
+    bool failedWrite = false;
+
+    // The patch owns stdout when it has no file of its own
+    bool patchToStdout = opts.diff && opts.outDir.empty();
+    std::ostream &issuesOut = patchToStdout ? err : out;
+    size_t failing = 0, unreadable = 0;
+    for (auto &r : results){
+        if (!r.ok){ ++unreadable; err << r.input << ": " << r.error << "\n"; continue; }
+        if (r.issueCount) ++failing;
+        if (opts.quiet) continue;
+        for (auto &msg : r.issues) issuesOut << r.input << ": " << msg << "\n";
+    }
+
+    if (opts.diff){
+        if (patchToStdout){
+            BatchRunner::writePatch(out, results);
+        } else {
+            fs::path patchPath = fs::path(opts.outDir) / "batch.patch";
+            std::ofstream patch(patchPath);
+            BatchRunner::writePatch(patch, results);
+            if (!patch){ err << patchPath.string() << ": cannot write" << "\n"; failedWrite = true; }
+        }
+    }
+
+    auto report = BatchRunner::formatReport(results);
+    if (batch.cache()) report.push_back(batch.cache()->stats());
+    if (!opts.logDir.empty()){
+        Logger logger;
+        fs::path reportPath = fs::path(opts.logDir) / "batch_report.txt";
+        if (!logger.init(opts.logDir) || !writeAllLines(reportPath.string(), report)){
+            err << opts.logDir << ": cannot write logs" << "\n";
+            failedWrite = true;
+        }
+        logger.writeAnalysis(report);
+        logger.flush();
+    }
+
+    if (opts.check) err << files.size() << " file(s) checked, " << failing << " need fixes" << "\n";
+    else err << report.front() << "\n";
+    if (batch.cache()) err << batch.cache()->stats() << "\n";
+    out.flush();
+    err.flush();
+
+    if (!errors.empty() || unreadable || failedWrite) return 2;
+    return opts.check && failing ? 1 : 0;
+}
+
+int runFilter(const CliOptions &opts, int inFd, int outFd, int issuesFd){
+    Trie trie; SymbolTable sym; Logger logger;
+    if (!opts.logDir.empty() && !logger.init(opts.logDir)){
+        std::cerr << opts.logDir << ": cannot write logs" << std::endl;
+        return 2;
+    }
+    Analyzer an(trie, sym, logger);
+    std::string passError;
+    if (!opts.passes.empty() && !an.configurePasses(opts.passes, &passError)){
+        std::cerr << "--passes: " << passError << std::endl;
+        return 2;
+    }
+    an.setThreads(opts.threads);
+    // Issues are formatted here, from the records, and only if they are shown
+    an.setFormatIssues(false);
+    std::vector<Issue> records;
+    an.setIssueSink(&records);
+
+    FdReader in(inFd);
+    FdWriter out(outFd), issues(issuesFd, 1 << 16);
+    in.tie(&out);
+    in.tie(&issues);
+    const bool showIssues = !opts.quiet && !opts.countOnly;
+    size_t issueCount = 0;
+    // A block's issues are all recorded before its first line is emitted; the
+    // end-of-file ones (line 0) arrive with the last block
+    auto drainIssues = [&]{
+        issueCount += records.size();
+        if (showIssues){
+            for (auto &issue : records){
+                issues.write(opts.stdinName);
+                if (issue.line){
+                    issues.write(": line ");
+                    issues.write(std::to_string(issue.line));
+                }
+                issues.write(": ");
+                issues.writeLine(an.formatIssue(issue));
+            }
+        }
+        records.clear();
+    };
+
+    std::vector<std::string> fileIssues; // stays empty: end-of-file issues are records too
+    an.processStream([&in](std::string &line){ return in.readLine(line); },
+                     [&in]{ return in.lineReady(); },
+                     [&](const std::string &fixed){ drainIssues(); out.writeLine(fixed); },
+                     fileIssues);
+    drainIssues();
+    if (opts.countOnly){
+        issues.write(opts.stdinName);
+        issues.writeLine(": " + std::to_string(issueCount) + " issues");
+    }
+
+    bool outOk = out.flush();
+    issues.flush();
+    if (in.failed()){ std::cerr << opts.stdinName << ": read error" << std::endl; return 2; }
+    if (!outOk){ std::cerr << "write error" << std::endl; return 2; }
+    return 0;
+}
+
+static DaemonServer *servingDaemon = nullptr;
+
+static void stopDaemon(int){
+    // stop() is a store and a write(): fine in a signal handler
+    if (servingDaemon) servingDaemon->stop();
+}
+
+int runServe(const CliOptions &opts, std::ostream &err){
+    DaemonServer server(opts.threads);
+    std::string error;
+    if (!opts.passes.empty() && !server.setPasses(opts.passes, &error)){
+        err << "--passes: " << error << std::endl;
+        return 2;
+    }
+    server.setHarvestDeclarations(opts.harvest);
+    if (!server.listen(opts.serveSocket, &error)){
+        err << error << std::endl;
+        return 2;
+    }
+    servingDaemon = &server;
+    std::signal(SIGINT, stopDaemon);
+    std::signal(SIGTERM, stopDaemon);
+    err << "intellifix: serving on " << opts.serveSocket << std::endl;
+    server.serve();
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+    servingDaemon = nullptr;
+    auto st = server.stats();
+    err << "intellifix: stopped after " << st.requests << " request(s) from " << st.connections << " connection(s)" << std::endl;
+    return 0;
+}
+
+int runLsp(const CliOptions &opts, int inFd, int outFd, std::ostream &err){
+    LspServer server;
+    std::string error;
+    if (!opts.passes.empty() && !server.setPasses(opts.passes, &error)){
+        err << "--passes: " << error << std::endl;
+        return 2;
+    }
+    return server.run(inFd, outFd);
+}
+
+int runClient(const CliOptions &opts, std::ostream &out, std::ostream &err){
+    DaemonRequest req;
+    req.command = opts.clientCommand;
+    req.first = opts.rangeFirst;
+    req.last = opts.rangeLast;
+    std::string name = opts.stdinName;
+    if (req.command == "FIX" || req.command == "RANGE"){
+        if (opts.inputs.empty()){
+            FdReader in(0);
+            std::string line;
+            while (in.readLine(line)) req.lines.push_back(line);
+            if (in.failed()){ err << name << ": read error" << std::endl; return 2; }
+        } else {
+            name = opts.inputs[0];
+            std::ifstream in(name);
+            if (!in.is_open()){ err << name << ": cannot read" << std::endl; return 2; }
+            std::string line;
+            while (std::getline(in, line)) req.lines.push_back(line);
+        }
+    }
+
+    DaemonClient client;
+    DaemonReply reply;
+    std::string error;
+    if (!client.connect(opts.connectSocket, &error)){ err << error << std::endl; return 2; }
+    if (!client.call(req, reply)){ err << opts.connectSocket << ": connection lost" << std::endl; return 2; }
+    if (!reply.ok){ err << opts.connectSocket << ": " << reply.error << std::endl; return 2; }
+    for (auto &l : reply.lines) out << l << '\n';
+    if (!opts.quiet) for (auto &msg : reply.issues) err << name << ": " << msg << '\n';
+    out.flush();
+    return 0;
+}
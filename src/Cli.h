@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Options of the non-interactive driver (intellifix [options] <files/dirs...>)
+struct CliOptions {
+    std::vector<std::string> inputs;
+    std::string outDir;        // corrected_* copies and batch.patch; empty = next to each input / stdout
+    std::string logDir;        // fixes.log, analysis.txt and batch_report.txt; empty = no logs
+    std::string cacheDir;      // result cache; empty = no cache
+    std::string passes;        // pass configuration, as for Analyzer::configurePasses
+    bool harvest = false;      // two-pass files: harvest every declaration before fixing
+    unsigned threads = 0;      // 0 = one per hardware thread
+    bool diff = false;         // write one unified diff instead of corrected copies
+    bool check = false;        // report issues only, write nothing
+    size_t maxIssues = 1;      // check mode: stop each file after this many issues
+    bool countOnly = false;
+    bool quiet = false;        // no per-issue output
+    bool interactive = false;  // fall back to the menu
+    bool filter = false;       // stdin -> stdout (input "-" or --filter)
+    int issuesFd = 2;          // filter mode: where issues go
+    std::string stdinName = "<stdin>"; // filter mode: file name used in issue lines
+    std::string serveSocket;   // run the daemon on this Unix socket
+    std::string connectSocket; // send the input to the daemon on this socket
+    std::string clientCommand = "FIX"; // FIX, RANGE, PING, STATS or SHUTDOWN
+    size_t rangeFirst = 0, rangeLast = 0;
+    bool lsp = false;          // language server on stdin/stdout
+    bool help = false;
+};
+
+// Parse the arguments after the program name. Returns false with a message on
+// bad usage. "--" ends the options; a lone "-" selects filter mode.
+bool parseCliArgs(const std::vector<std::string> &args, CliOptions &opts, std::string &error);
+
+std::string cliUsage();
+
+// Run a parsed command line without ever reading stdin. Issues go to `out` as
+// "path: line N: message" (to `err` when the patch itself goes to `out`),
+// progress and the summary to `err`.
+// Exit status: 0 done, 1 check mode found issues, 2 usage or read/write errors.
+int runCli(const CliOptions &opts, std::ostream &out, std::ostream &err);
+
+// Filter mode: fix the source read from inFd and write it to outFd, a block of
+// lines at a time as input arrives, with "name: line N: message" issue lines on
+// issuesFd. Reads and writes go through large fd buffers (FastIO.h), flushed
+// only when full or when the next read would wait for input.
+// Exit status: 0 done, 2 usage or read/write errors.
+int runFilter(const CliOptions &opts, int inFd, int outFd, int issuesFd);
+
+// Daemon mode (Daemon.h): serve on opts.serveSocket until SIGINT/SIGTERM or a
+// SHUTDOWN request. Exit status: 0 after a clean stop, 2 if it cannot listen.
+int runServe(const CliOptions &opts, std::ostream &err);
+
+// Client of a running daemon: sends the one input file (stdin if none or "-")
+// and writes the fixed lines to out and the issues to err, as the filter does;
+// PING/STATS/SHUTDOWN print the daemon's answer.
+// Exit status: 0 done, 2 usage, connection or request errors.
+int runClient(const CliOptions &opts, std::ostream &out, std::ostream &err);
+
+// Language server mode (LspServer.h): JSON-RPC on inFd/outFd until "exit".
+// Exit status: 0 after shutdown/exit, 1 if input ended or exit came without
+// shutdown, 2 on a bad --passes spec.
+int runLsp(const CliOptions &opts, int inFd, int outFd, std::ostream &err);
+
+// Where the interactive session keeps its logs when none is given:
+// %USERPROFILE%\Documents\IntelliFixPP\output on Windows,
+// $XDG_STATE_HOME/intellifix (or ~/.local/state/intellifix) elsewhere,
+// ./output if no home directory is known.
+std::string defaultLogDir();
@@ -0,0 +1,34 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+// Cache of dictionary decisions for identifiers: word -> correction ("" = keep
+// the word). Valid while the dictionary is unchanged; one per rule context, so
+// no locking. Cleared wholesale when it reaches kMaxEntries to bound memory on
+// endless streams of distinct words.
+class CorrectionMemo {
+public:
+    static const size_t kMaxEntries = 1 << 16;
+
+    // nullptr on a miss
+    const std::string *find(const std::string &word){
+        ++lookups;
+        auto it = map_.find(word);
+        if (it == map_.end()) return nullptr;
+        ++hits;
+        return &it->second;
+    }
+    const std::string &store(const std::string &word, std::string correction){
+        if (map_.size() >= kMaxEntries) map_.clear();
+        return map_.insert_or_assign(word, std::move(correction)).first->second;
+    }
+    void clear() { map_.clear(); }
+    size_t size() const { return map_.size(); }
+
+    uint64_t hits = 0;
+    uint64_t lookups = 0;
+
+private:
+    std::unordered_map<std::string, std::string> map_;
+};
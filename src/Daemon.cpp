@@ -0,0 +1,349 @@
+#include "Daemon.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include "Logger.h"
+#include "SymbolTable.h"
+#include "ThreadPool.h"
+#include "Utils.h"
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0 // macOS: no per-call flag
+#endif
+#endif
+
+// Per pool worker, alive as long as serve() runs
+struct DaemonServer::Worker {
+    SymbolTable sym;
+    Logger log;  // never init()ed: per-line logging is discarded
+    std::unique_ptr<Analyzer> an;
+    std::vector<Issue> records;
+};
+
+DaemonServer::DaemonServer(unsigned threads) : threads_(threads) {}
+
+bool DaemonServer::setPasses(const std::string &spec, std::string *error){
+    SymbolTable sym; Logger log;
+    Analyzer probe(trie_, sym, log);
+    if (!probe.configurePasses(spec, error)) return false;
+    passes_ = spec;
+    return true;
+}
+
+DaemonServer::Stats DaemonServer::stats() const {
+    Stats s;
+    s.connections = connections_;
+    s.requests = requests_;
+    s.errors = errors_;
+    s.serviceUs = serviceUs_;
+    return s;
+}
+
+std::string DaemonServer::handle(Worker &w, const std::string &payload){
+    auto start = std::chrono::steady_clock::now();
+    DaemonRequest req;
+    DaemonReply reply;
+    ++requests_;
+    if (!decodeRequest(payload, req, &reply.error)){
+        ++errors_;
+        return encodeReply(reply);
+    }
+    reply.ok = true;
+    Analyzer &an = *w.an;
+    w.records.clear();
+    if (req.command == "FIX"){
+        std::vector<std::string> fileIssues; // stays empty: end-of-file issues are records too
+        reply.lines = an.processFile(req.lines, fileIssues);
+        for (auto &issue : w.records){
+            reply.issues.push_back(issue.line ? "line " + std::to_string(issue.line) + ": " + an.formatIssue(issue) : an.formatIssue(issue));
+        }
+    } else if (req.command == "RANGE" || req.command == "LINE"){
+        if (req.command == "LINE"){
+            req.first = req.last = 1;
+            if (req.lines.empty()) req.lines.emplace_back();
+        }
+        if (req.first > req.lines.size()){
+            reply.ok = false;
+            reply.error = "RANGE starts after the last line (" + std::to_string(req.lines.size()) + ")";
+        } else {
+            // Lines before the range only build up the state the range starts from
+            an.resetFileState();
+            size_t last = std::min(req.last, req.lines.size());
+            for (size_t i=0; i<last; ++i){
+                if (i + 1 == req.first) w.records.clear();
+                auto r = an.processLine(req.lines[i], i + 1);
+                if (i + 1 >= req.first) reply.lines.push_back(std::move(r.corrected));
+            }
+            for (auto &issue : w.records) reply.issues.push_back("line " + std::to_string(issue.line) + ": " + an.formatIssue(issue));
+        }
+    } else if (req.command == "STATS"){
+        Stats s = stats();
+        reply.lines = {
+            "connections " + std::to_string(s.connections),
+            "requests " + std::to_string(s.requests),
+            "errors " + std::to_string(s.errors),
+            "service_us " + std::to_string(s.serviceUs),
+            "workers " + std::to_string(threads_),
+            "issue_names " + std::to_string(an.issueNames().size()), // of the worker answering
+        };
+    } else if (req.command == "SHUTDOWN"){
+        stop();
+    }
+    w.records.clear();
+    serviceUs_ += (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    return encodeReply(reply);
+}
+
+#ifndef _WIN32
+
+static bool setNonBlocking(int fd){
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0 && fcntl(fd, F_SETFD, FD_CLOEXEC) == 0;
+}
+
+DaemonServer::~DaemonServer(){
+    if (listenFd_ >= 0) ::close(listenFd_);
+    if (wake_[0] >= 0) ::close(wake_[0]);
+    if (wake_[1] >= 0) ::close(wake_[1]);
+}
+
+bool DaemonServer::listen(const std::string &socketPath, std::string *error){
+    auto fail = [&](const std::string &what){
+        if (error) *error = socketPath + ": " + what;
+        return false;
+    };
+    sockaddr_un addr{};
+    if (socketPath.size() >= sizeof(addr.sun_path)) return fail("socket path too long");
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    // Replace a stale socket file, but never a live daemon or a regular file
+    struct stat st;
+    if (::lstat(socketPath.c_str(), &st) == 0){
+        if (!S_ISSOCK(st.st_mode)) return fail("exists and is not a socket");
+        DaemonClient probe;
+        if (probe.connect(socketPath)) return fail("a daemon is already listening");
+        ::unlink(socketPath.c_str());
+    }
+
+    if (::pipe(wake_) != 0 || !setNonBlocking(wake_[0]) || !setNonBlocking(wake_[1])) return fail(std::strerror(errno));
+    listenFd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd_ < 0 || !setNonBlocking(listenFd_)) return fail(std::strerror(errno));
+    // Only the owner may submit code: create the socket 0600 rather than
+    // narrowing it after bind, when others could already connect
+    mode_t oldMask = ::umask(0077);
+    int bound = ::bind(listenFd_, (sockaddr *)&addr, sizeof(addr));
+    int bindErr = errno;
+    ::umask(oldMask);
+    if (bound != 0) return fail(std::strerror(bindErr));
+    if (::chmod(socketPath.c_str(), 0600) != 0){
+        int chmodErr = errno;
+        ::unlink(socketPath.c_str());
+        return fail(std::strerror(chmodErr));
+    }
+    if (::listen(listenFd_, 128) != 0) return fail(std::strerror(errno));
+    path_ = socketPath;
+
+    // Warm up before the first client: the dictionary is shared read-only by all workers
+    if (trie_.allWords().empty()) trie_.loadDefaultDictionary();
+    return true;
+}
+
+void DaemonServer::wake(){
+    char c = 1;
+    if (wake_[1] >= 0 && ::write(wake_[1], &c, 1) < 0){
+        // Pipe full: a wake-up is already pending
+    }
+}
+
+void DaemonServer::stop(){
+    stop_ = true;
+    wake();
+}
+
+bool DaemonServer::flushOut(Conn &c){
+    while (c.outPos < c.out.size()){
+        ssize_t n = ::send(c.fd, c.out.data() + c.outPos, c.out.size() - c.outPos, MSG_NOSIGNAL);
+        if (n > 0){ c.outPos += (size_t)n; continue; }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+        return false;
+    }
+    c.out.clear();
+    c.outPos = 0;
+    return true;
+}
+
+void DaemonServer::serve(){
+    if (listenFd_ < 0) return;
+    WorkStealingPool pool(threads_);
+    threads_ = pool.size();
+    std::vector<Worker> workers(pool.size());
+    for (auto &w : workers){
+        w.an = std::make_unique<Analyzer>(trie_, w.sym, w.log);
+        w.an->setThreads(1); // parallelism is across requests
+        w.an->setFormatIssues(false);
+        w.an->setIssueSink(&w.records);
+        w.an->setHarvestDeclarations(harvest_);
+        if (!passes_.empty()) w.an->configurePasses(passes_);
+    }
+
+    std::map<uint64_t, Conn> conns;
+    uint64_t nextId = 1;
+    std::vector<pollfd> fds;
+    std::vector<uint64_t> ids;
+    std::vector<Done> done;
+    std::string payload;
+
+    auto dispatch = [&](uint64_t id, Conn &c){
+        if (c.busy || c.pending.empty() || stop_) return;
+        c.busy = true;
+        pool.submit([this, &workers, id, req = std::move(c.pending.front())](unsigned wi){
+            std::string reply = handle(workers[wi], req);
+            {
+                std::lock_guard<std::mutex> lock(doneMutex_);
+                done_.push_back({id, std::move(reply)});
+            }
+            wake();
+        });
+        c.pending.pop_front();
+    };
+    auto closeConn = [&](std::map<uint64_t, Conn>::iterator it){
+        ::close(it->second.fd);
+        conns.erase(it);
+    };
+    auto closeIfDone = [&](std::map<uint64_t, Conn>::iterator it){
+        const Conn &c = it->second;
+        if (c.closing && !c.busy && c.pending.empty() && c.out.empty()) closeConn(it);
+    };
+
+    // After stop(), give clients this long to take their last replies
+    const auto kDrainTime = std::chrono::seconds(2);
+    std::chrono::steady_clock::time_point deadline;
+    bool stopping = false;
+    while (true){
+        if (stop_ && !stopping){
+            stopping = true;
+            deadline = std::chrono::steady_clock::now() + kDrainTime;
+        }
+        if (stopping){
+            bool idle = true;
+            for (auto &kv : conns) idle = idle && !kv.second.busy && kv.second.out.empty();
+            if (idle || std::chrono::steady_clock::now() > deadline) break;
+        }
+
+        fds.clear(); ids.clear();
+        fds.push_back({wake_[0], POLLIN, 0});
+        fds.push_back({listenFd_, (short)(stopping ? 0 : POLLIN), 0});
+        for (auto &kv : conns){
+            short events = 0;
+            if (!kv.second.closing) events |= POLLIN;
+            if (!kv.second.out.empty()) events |= POLLOUT;
+            // A hung-up socket would report POLLHUP on every poll while its request runs
+            if (!events) continue;
+            fds.push_back({kv.second.fd, events, 0});
+            ids.push_back(kv.first);
+        }
+        if (::poll(fds.data(), fds.size(), stopping ? 50 : -1) < 0 && errno != EINTR) break;
+
+        // Finished replies
+        if (fds[0].revents & POLLIN){
+            char sink[256];
+            while (::read(wake_[0], sink, sizeof(sink)) > 0){}
+            {
+                std::lock_guard<std::mutex> lock(doneMutex_);
+                done.swap(done_);
+            }
+            for (auto &d : done){
+                auto it = conns.find(d.conn);
+                if (it == conns.end()) continue; // client went away meanwhile
+                Conn &c = it->second;
+                c.busy = false;
+                appendFrame(c.out, d.reply);
+                if (!flushOut(c)){ closeConn(it); continue; }
+                dispatch(d.conn, c);
+                closeIfDone(it);
+            }
+            done.clear();
+        }
+
+        if (fds[1].revents & POLLIN){
+            while (true){
+                int fd = ::accept(listenFd_, nullptr, nullptr);
+                if (fd < 0) break;
+                if (!setNonBlocking(fd)){ ::close(fd); continue; }
+                conns[nextId++].fd = fd;
+                ++connections_;
+            }
+        }
+
+        for (size_t k=0; k<ids.size(); ++k){
+            auto it = conns.find(ids[k]);
+            if (it == conns.end()) continue;
+            Conn &c = it->second;
+            short re = fds[k + 2].revents;
+            bool broken = (re & POLLNVAL) != 0;
+            if (!c.closing && (re & (POLLIN | POLLHUP | POLLERR))){
+                char chunk[1 << 16];
+                while (true){
+                    ssize_t n = ::recv(c.fd, chunk, sizeof(chunk), 0);
+                    if (n > 0){ c.in.append(chunk, (size_t)n); continue; }
+                    if (n < 0 && errno == EINTR) continue;
+                    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+                    c.closing = true; // end of input (or a reset)
+                    break;
+                }
+                FrameStatus st;
+                while ((st = takeFrame(c.in, c.inPos, payload)) == FrameStatus::FRAME) c.pending.push_back(std::move(payload));
+                if (st == FrameStatus::TOO_LARGE){
+                    ++errors_;
+                    DaemonReply err;
+                    err.error = "frame too large";
+                    appendFrame(c.out, encodeReply(err));
+                    c.closing = true;
+                    c.pending.clear();
+                    c.in.clear();
+                    c.inPos = 0;
+                }
+                if (c.inPos > 0){ c.in.erase(0, c.inPos); c.inPos = 0; }
+                dispatch(ids[k], c);
+            }
+            if (!broken && !c.out.empty()) broken = !flushOut(c);
+            if (broken) closeConn(it);
+            else closeIfDone(it);
+        }
+    }
+
+    pool.wait();
+    for (auto &kv : conns) ::close(kv.second.fd);
+    ::close(listenFd_);
+    listenFd_ = -1;
+    ::unlink(path_.c_str());
+}
+
+#else
+
+DaemonServer::~DaemonServer() {}
+
+bool DaemonServer::listen(const std::string &socketPath, std::string *error){
+    if (error) *error = socketPath + ": the daemon needs Unix domain sockets";
+    return false;
+}
+
+void DaemonServer::serve() {}
+
+void DaemonServer::wake() {}
+
+void DaemonServer::stop(){ stop_ = true; }
+
+bool DaemonServer::flushOut(Conn &){ return false; }
+
+#endif
@@ -0,0 +1,83 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "DaemonProtocol.h"
+#include "Trie.h"
+
+// Long-lived correction server on a Unix domain socket (protocol in
+// DaemonProtocol.h). The dictionary is built once and every pool worker keeps
+// its own Analyzer (symbol table, correction memo) for the daemon's lifetime,
+// so a request pays only for fixing its lines. One thread runs a poll() loop
+// that accepts clients and moves bytes; decoded requests go to a work-stealing
+// pool and finished replies come back through a wake-up pipe. A connection has
+// at most one request in flight, which keeps its replies in request order.
+// POSIX only: on Windows listen() fails.
+class DaemonServer {
+public:
+    explicit DaemonServer(unsigned threads = 0); // 0 = one worker per hardware thread
+    ~DaemonServer();
+
+    DaemonServer(const DaemonServer &) = delete;
+    DaemonServer &operator=(const DaemonServer &) = delete;
+
+    // Pass configuration for every worker, as for Analyzer::configurePasses
+    bool setPasses(const std::string &spec, std::string *error = nullptr);
+    // Two-pass files for every worker (Analyzer::setHarvestDeclarations)
+    void setHarvestDeclarations(bool on) { harvest_ = on; }
+
+    // Bind the socket (an existing socket file there is replaced) and build the
+    // dictionary; false with a message on failure
+    bool listen(const std::string &socketPath, std::string *error = nullptr);
+    // Serve until stop() or a SHUTDOWN request; removes the socket file on return
+    void serve();
+    // Make serve() return once in-flight requests are answered; callable from any thread
+    void stop();
+
+    struct Stats {
+        uint64_t connections = 0;
+        uint64_t requests = 0;
+        uint64_t errors = 0;      // malformed requests and oversized frames
+        uint64_t serviceUs = 0;   // total time spent fixing, in microseconds
+    };
+    Stats stats() const;
+
+private:
+    struct Conn {
+        int fd = -1;
+        std::string in, out;
+        size_t inPos = 0, outPos = 0;
+        std::deque<std::string> pending;  // decoded request payloads not yet started
+        bool busy = false;                // a request is with the pool
+        bool closing = false;             // peer is done sending, or a protocol error
+    };
+    struct Done {
+        uint64_t conn;
+        std::string reply;
+    };
+    struct Worker;
+
+    Trie trie_;
+    unsigned threads_;
+    std::string passes_;
+    bool harvest_ = false;
+    std::string path_;
+    int listenFd_ = -1;
+    int wake_[2] = {-1, -1};
+    std::atomic<bool> stop_{false};
+
+    std::mutex doneMutex_;
+    std::vector<Done> done_;
+
+    std::atomic<uint64_t> connections_{0}, requests_{0}, errors_{0}, serviceUs_{0};
+
+    // Body of a request, run on a pool worker
+    std::string handle(Worker &w, const std::string &payload);
+    void wake();
+    // Send what the socket takes without blocking; false if the connection broke
+    static bool flushOut(Conn &c);
+};
@@ -0,0 +1,177 @@
+#include "DaemonProtocol.h"
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <sstream>
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0 // macOS: no per-call flag
+#endif
+#endif
+
+// Split body text made of '\n'-terminated lines
+static void splitBody(std::string_view body, std::vector<std::string> &lines){
+    lines.clear();
+    size_t start = 0;
+    while (start < body.size()){
+        size_t nl = body.find('\n', start);
+        if (nl == std::string_view::npos) nl = body.size();
+        lines.emplace_back(body.substr(start, nl - start));
+        start = nl + 1;
+    }
+}
+
+static void appendLines(std::string &out, const std::vector<std::string> &lines){
+    for (auto &l : lines){ out += l; out += '\n'; }
+}
+
+std::string encodeRequest(const DaemonRequest &request){
+    std::string out = request.command;
+    if (request.command == "RANGE") out += " " + std::to_string(request.first) + " " + std::to_string(request.last);
+    out += '\n';
+    appendLines(out, request.lines);
+    return out;
+}
+
+bool decodeRequest(std::string_view payload, DaemonRequest &request, std::string *error){
+    size_t nl = payload.find('\n');
+    std::string head(payload.substr(0, nl));
+    std::istringstream iss(head);
+    request = DaemonRequest();
+    iss >> request.command;
+    if (request.command == "RANGE"){
+        if (!(iss >> request.first >> request.last) || request.first == 0 || request.last < request.first){
+            if (error) *error = "RANGE needs 1-based first <= last";
+            return false;
+        }
+    } else if (request.command != "FIX" && request.command != "LINE" && request.command != "PING"
+               && request.command != "STATS" && request.command != "SHUTDOWN"){
+        if (error) *error = "unknown command: " + request.command;
+        return false;
+    }
+    if (nl != std::string_view::npos) splitBody(payload.substr(nl + 1), request.lines);
+    if (request.command == "LINE" && request.lines.size() > 1){
+        if (error) *error = "LINE takes one line";
+        return false;
+    }
+    return true;
+}
+
+std::string encodeReply(const DaemonReply &reply){
+    if (!reply.ok) return "ERR " + reply.error + "\n";
+    std::string out = "OK " + std::to_string(reply.lines.size()) + " " + std::to_string(reply.issues.size()) + "\n";
+    appendLines(out, reply.lines);
+    appendLines(out, reply.issues);
+    return out;
+}
+
+bool decodeReply(std::string_view payload, DaemonReply &reply){
+    reply = DaemonReply();
+    size_t nl = payload.find('\n');
+    if (nl == std::string_view::npos) return false;
+    std::string head(payload.substr(0, nl));
+    if (head.compare(0, 4, "ERR ") == 0){
+        reply.error = head.substr(4);
+        return true;
+    }
+    std::istringstream iss(head);
+    std::string ok;
+    size_t lines = 0, issues = 0;
+    if (!(iss >> ok >> lines >> issues) || ok != "OK") return false;
+    std::vector<std::string> all;
+    splitBody(payload.substr(nl + 1), all);
+    if (all.size() != lines + issues) return false;
+    reply.ok = true;
+    reply.lines.assign(std::make_move_iterator(all.begin()), std::make_move_iterator(all.begin() + lines));
+    reply.issues.assign(std::make_move_iterator(all.begin() + lines), std::make_move_iterator(all.end()));
+    return true;
+}
+
+void appendFrame(std::string &out, std::string_view payload){
+    uint32_t n = (uint32_t)payload.size();
+    char len[4] = {(char)(n >> 24), (char)(n >> 16), (char)(n >> 8), (char)n};
+    out.append(len, 4);
+    out.append(payload.data(), payload.size());
+}
+
+FrameStatus takeFrame(const std::string &buf, size_t &pos, std::string &payload, size_t maxPayload){
+    if (buf.size() - pos < 4) return FrameStatus::NEED_MORE;
+    const unsigned char *p = (const unsigned char *)buf.data() + pos;
+    size_t n = ((size_t)p[0] << 24) | ((size_t)p[1] << 16) | ((size_t)p[2] << 8) | p[3];
+    if (n > maxPayload) return FrameStatus::TOO_LARGE;
+    if (buf.size() - pos - 4 < n) return FrameStatus::NEED_MORE;
+    payload.assign(buf, pos + 4, n);
+    pos += 4 + n;
+    return FrameStatus::FRAME;
+}
+
+#ifndef _WIN32
+
+bool DaemonClient::connect(const std::string &socketPath, std::string *error){
+    close();
+    sockaddr_un addr{};
+    if (socketPath.size() >= sizeof(addr.sun_path)){
+        if (error) *error = "socket path too long: " + socketPath;
+        return false;
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, socketPath.c_str(), socketPath.size() + 1);
+    fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd_ < 0 || ::connect(fd_, (sockaddr *)&addr, sizeof(addr)) != 0){
+        if (error) *error = socketPath + ": " + std::strerror(errno);
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool DaemonClient::call(std::string_view request, std::string &reply){
+    if (fd_ < 0) return false;
+    std::string frame;
+    appendFrame(frame, request);
+    for (size_t sent = 0; sent < frame.size();){
+        ssize_t n = ::send(fd_, frame.data() + sent, frame.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0){ close(); return false; }
+        sent += (size_t)n;
+    }
+    size_t pos = 0;
+    while (true){
+        FrameStatus st = takeFrame(buf_, pos, reply);
+        if (st == FrameStatus::FRAME){ buf_.erase(0, pos); return true; }
+        if (st == FrameStatus::TOO_LARGE){ close(); return false; }
+        char chunk[1 << 16];
+        ssize_t n = ::recv(fd_, chunk, sizeof(chunk), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0){ close(); return false; }
+        buf_.append(chunk, (size_t)n);
+    }
+}
+
+void DaemonClient::close(){
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = -1;
+    buf_.clear();
+}
+
+#else
+
+bool DaemonClient::connect(const std::string &socketPath, std::string *error){
+    if (error) *error = socketPath + ": the daemon needs Unix domain sockets";
+    return false;
+}
+
+bool DaemonClient::call(std::string_view, std::string &){ return false; }
+
+void DaemonClient::close(){}
+
+#endif
+
+bool DaemonClient::call(const DaemonRequest &request, DaemonReply &reply){
+    std::string payload;
+    return call(encodeRequest(request), payload) && decodeReply(payload, reply);
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Wire format of the correction daemon (see Daemon.h). Every message is a frame:
+// a 4-byte big-endian payload length followed by the payload. A request payload
+// is one command line, then the buffer, every line ending in '\n':
+//   FIX            fix the whole buffer
+//   RANGE <a> <b>  fix the buffer up to line b, return lines a..b (1-based, inclusive)
+//   LINE           fix the one body line as line 1 of a new file
+//   PING, STATS, SHUTDOWN (no body)
+// A reply payload is "OK <lines> <issues>\n", then that many fixed lines and
+// issue lines ("line N: message", or an end-of-file message), or "ERR <message>\n".
+// Requests on one connection are answered in order; clients may pipeline them.
+
+struct DaemonRequest {
+    std::string command;             // FIX, RANGE, LINE, PING, STATS, SHUTDOWN
+    size_t first = 0, last = 0;      // RANGE only
+    std::vector<std::string> lines;
+};
+
+struct DaemonReply {
+    bool ok = false;
+    std::string error;               // when !ok
+    std::vector<std::string> lines;
+    std::vector<std::string> issues;
+};
+
+// Largest payload either side accepts; a bigger length closes the connection
+static const size_t kMaxFramePayload = 64u << 20;
+
+std::string encodeRequest(const DaemonRequest &request);
+bool decodeRequest(std::string_view payload, DaemonRequest &request, std::string *error = nullptr);
+std::string encodeReply(const DaemonReply &reply);
+bool decodeReply(std::string_view payload, DaemonReply &reply);
+
+// Append the frame for payload to out
+void appendFrame(std::string &out, std::string_view payload);
+
+enum class FrameStatus { NEED_MORE, FRAME, TOO_LARGE };
+// Take the frame starting at buf[pos], if it is complete: its payload goes to
+// payload and pos moves past it
+FrameStatus takeFrame(const std::string &buf, size_t &pos, std::string &payload, size_t maxPayload = kMaxFramePayload);
+
+// Blocking client end of a daemon connection: one call() per request
+class DaemonClient {
+public:
+    DaemonClient() = default;
+    ~DaemonClient() { close(); }
+    DaemonClient(const DaemonClient &) = delete;
+    DaemonClient &operator=(const DaemonClient &) = delete;
+
+    bool connect(const std::string &socketPath, std::string *error = nullptr);
+    // Send one request and wait for its reply; false if the connection failed
+    bool call(const DaemonRequest &request, DaemonReply &reply);
+    // The same with already encoded payloads
+    bool call(std::string_view request, std::string &reply);
+    void close();
+
+    bool connected() const { return fd_ >= 0; }
+
+private:
+    int fd_ = -1;
+    std::string buf_;
+};
@@ -0,0 +1,121 @@
+#include "DiffWriter.h"
+
+DiffWriter::DiffWriter(std::ostream &out, std::string oldName, std::string newName, size_t context)
+    : out_(out), oldName_(std::move(oldName)), newName_(std::move(newName)), context_(context) {}
+
+void DiffWriter::line(const std::string &original, const std::string &corrected){
+    if (original == corrected){ unchanged(original); return; }
+    beginChange();
+    body_.push_back("-" + original);
+    body_.push_back("+" + corrected);
+    ++countOld_; ++countNew_;
+    ++oldNo_; ++newNo_;
+    ++changed_;
+}
+
+void DiffWriter::added(const std::string &corrected){
+    beginChange();
+    body_.push_back("+" + corrected);
+    ++countNew_;
+    ++newNo_;
+    ++changed_;
+}
+
+void DiffWriter::unchanged(const std::string &text){
+    ++oldNo_; ++newNo_;
+    last_ = text;
+    if (open_ && trailing_ < context_){
+        body_.push_back(" " + text);
+        ++countOld_; ++countNew_;
+        ++trailing_;
+        return;
+    }
+    held_.push_back(text);
+    // Gap longer than two contexts: the open hunk is complete
+    if (open_ && held_.size() > context_) flush();
+    if (!open_ && held_.size() > context_) held_.pop_front();
+}
+
+// Open a hunk (or extend the open one across the held gap) before a change
+void DiffWriter::beginChange(){
+    if (!open_){
+        open_ = true;
+        body_.clear();
+        hunkOld_ = oldNo_ - held_.size();
+        hunkNew_ = newNo_ - held_.size();
+        countOld_ = countNew_ = 0;
+    }
+    for (auto &text : held_) body_.push_back(" " + text);
+    countOld_ += held_.size();
+    countNew_ += held_.size();
+    held_.clear();
+    trailing_ = 0;
+}
+
+void DiffWriter::flush(){
+    if (!open_) return;
+    if (hunks_++ == 0) out_ << "--- " << oldName_ << "\n+++ " << newName_ << "\n";
+    // An empty range is addressed by the line before it
+    out_ << "@@ -" << (countOld_ ? hunkOld_ + 1 : hunkOld_) << "," << countOld_
+         << " +" << (countNew_ ? hunkNew_ + 1 : hunkNew_) << "," << countNew_ << " @@\n";
+    for (auto &l : body_) out_ << l << "\n";
+    body_.clear();
+    open_ = false;
+}
+
+// The marker follows the last line of the side it applies to. That line must
+// be in a hunk, and a context line cannot carry the marker for one side only.
+void DiffWriter::markNoNewline(){
+    static const char kMarker[] = "\\ No newline at end of file";
+    bool inHunk = open_ && hunkOld_ + countOld_ == oldNo_ && hunkNew_ + countNew_ == newNo_;
+    if (!inHunk){
+        if (oldNoEol_ == newNoEol_) return; // same on both sides and not near a change
+        // The last line was unchanged and is held (or, without context, gone)
+        if (held_.empty()) held_.push_back(last_);
+        beginChange();
+    }
+    const size_t none = (size_t)-1;
+    size_t lastOld = none, lastNew = none;
+    for (size_t k=body_.size(); k-- > 0 && (lastOld == none || lastNew == none);){
+        if (lastOld == none && body_[k][0] != '+') lastOld = k;
+        if (lastNew == none && body_[k][0] != '-') lastNew = k;
+    }
+    auto split = [&](size_t k){
+        std::string text = body_[k].substr(1);
+        body_[k] = "-" + text;
+        body_.insert(body_.begin() + k + 1, "+" + text);
+        ++changed_;
+    };
+    if (lastOld != none && lastOld == lastNew){
+        if (oldNoEol_ == newNoEol_){
+            body_.insert(body_.begin() + lastOld + 1, kMarker);
+            return;
+        }
+        split(lastOld);
+        lastNew = lastOld + 1;
+    } else if (oldNoEol_ && lastOld != none && body_[lastOld][0] == ' '){
+        split(lastOld);
+        ++lastNew;
+    }
+    // New side first: it comes later in the hunk
+    if (newNoEol_ && lastNew != none) body_.insert(body_.begin() + lastNew + 1, kMarker);
+    if (oldNoEol_ && lastOld != none) body_.insert(body_.begin() + lastOld + 1, kMarker);
+}
+
+void DiffWriter::finish(){
+    if ((oldNoEol_ && oldNo_) || (newNoEol_ && newNo_)) markNoNewline();
+    flush();
+    held_.clear();
+}
+
+size_t DiffWriter::write(std::ostream &out, const std::string &oldName, const std::string &newName,
+                         const std::vector<std::string> &original, const std::vector<std::string> &corrected,
+                         size_t context, bool originalEndsWithNewline){
+    DiffWriter diff(out, oldName, newName, context);
+    diff.setNoNewlineAtEnd(!originalEndsWithNewline);
+    size_t i = 0;
+    for (; i<original.size() && i<corrected.size(); ++i) diff.line(original[i], corrected[i]);
+    for (; i<corrected.size(); ++i) diff.added(corrected[i]);
+    diff.finish();
+    return diff.hunks();
+}
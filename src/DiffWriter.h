@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <deque>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Writes a unified diff of a fix run while the lines stream past. The fixer
+// never moves lines around: input line i becomes output line i, plus lines it
+// appends at the end (missing '}'), so hunks follow from a per-line "changed?"
+// test and no general diff algorithm is needed. Only the open hunk and up to
+// `context` unchanged lines are held in memory. Nothing is written for a file
+// without changes. The result applies with `patch -p0`. A side whose last line
+// has no newline gets the "\ No newline at end of file" marker; the fixer's own
+// output always ends with one, so a missing newline in the input is a change.
+class DiffWriter {
+public:
+    DiffWriter(std::ostream &out, std::string oldName, std::string newName, size_t context = 3);
+
+    // Next input line and what the fixer made of it
+    void line(const std::string &original, const std::string &corrected);
+    // Output line with no input counterpart (appended after the last input line)
+    void added(const std::string &corrected);
+    // The last line of the old/new side has no newline; call before finish()
+    void setNoNewlineAtEnd(bool oldSide, bool newSide = false){ oldNoEol_ = oldSide; newNoEol_ = newSide; }
+    // Write the last hunk; call once after the final line
+    void finish();
+
+    size_t hunks() const { return hunks_; }
+    size_t changedLines() const { return changed_; }
+
+    // Whole-file convenience: input lines, then the fixed lines (which may be
+    // longer); the fixed text always ends with a newline, the input may not
+    static size_t write(std::ostream &out, const std::string &oldName, const std::string &newName,
+                        const std::vector<std::string> &original, const std::vector<std::string> &corrected,
+                        size_t context = 3, bool originalEndsWithNewline = true);
+
+private:
+    std::ostream &out_;
+    std::string oldName_, newName_;
+    size_t context_;
+
+    size_t oldNo_ = 0, newNo_ = 0;  // lines consumed so far
+    std::deque<std::string> held_;  // unchanged lines not (yet) in a hunk, at most context_
+    bool open_ = false;
+    std::vector<std::string> body_; // open hunk, with ' ', '-', '+' prefixes
+    size_t hunkOld_ = 0, hunkNew_ = 0, countOld_ = 0, countNew_ = 0;
+    size_t trailing_ = 0;           // context lines after the last change in body_
+    size_t hunks_ = 0, changed_ = 0;
+    std::string last_;              // last unchanged line, in case it has to join a hunk at the end
+    bool oldNoEol_ = false, newNoEol_ = false;
+
+    void unchanged(const std::string &text);
+    void markNoNewline();
+    void beginChange();
+    void flush();
+};
@@ -0,0 +1,113 @@
+#include "FastIO.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+static long long sysRead(int fd, char *data, size_t n){
+#ifdef _WIN32
+    return _read(fd, data, (unsigned)n);
+#else
+    return ::read(fd, data, n);
+#endif
+}
+
+static long long sysWrite(int fd, const char *data, size_t n){
+#ifdef _WIN32
+    return _write(fd, data, (unsigned)n);
+#else
+    return ::write(fd, data, n);
+#endif
+}
+
+FdReader::FdReader(int fd, size_t bufferSize) : fd_(fd), buf_(bufferSize ? bufferSize : 1) {}
+
+bool FdReader::lineReady() const {
+    if (eof_ || failed_) return true;
+    return std::memchr(buf_.data() + begin_, '\n', end_ - begin_) != nullptr;
+}
+
+// Read more input after the unread bytes; false at end of input or on error
+bool FdReader::fill(){
+    if (eof_ || failed_) return false;
+    if (begin_ > 0){
+        std::memmove(buf_.data(), buf_.data() + begin_, end_ - begin_);
+        end_ -= begin_;
+        begin_ = 0;
+    }
+    if (end_ == buf_.size()) buf_.resize(buf_.size() * 2); // one line longer than the buffer
+    for (auto *w : tied_) w->flush();
+    while (true){
+        long long got = sysRead(fd_, buf_.data() + end_, buf_.size() - end_);
+        if (got > 0){ end_ += (size_t)got; return true; }
+        if (got == 0){ eof_ = true; return false; }
+        if (errno == EINTR) continue;
+        failed_ = true;
+        return false;
+    }
+}
+
+bool FdReader::readLine(std::string &line){
+    size_t scanned = begin_;
+    while (true){
+        const char *nl = (const char *)std::memchr(buf_.data() + scanned, '\n', end_ - scanned);
+        if (nl){
+            size_t at = (size_t)(nl - buf_.data());
+            line.assign(buf_.data() + begin_, at - begin_);
+            begin_ = at + 1;
+            return true;
+        }
+        size_t offset = end_ - begin_; // fill() moves the unread bytes to the front
+        if (!fill()){
+            if (begin_ == end_) return false;
+            line.assign(buf_.data() + begin_, end_ - begin_);
+            begin_ = end_;
+            return true;
+        }
+        scanned = offset;
+    }
+}
+
+bool FdReader::read(size_t n, std::string &out){
+    out.clear();
+    while (true){
+        size_t take = std::min(n - out.size(), end_ - begin_);
+        out.append(buf_.data() + begin_, take);
+        begin_ += take;
+        if (out.size() == n) return true;
+        if (!fill()) return false;
+    }
+}
+
+FdWriter::FdWriter(int fd, size_t bufferSize) : fd_(fd), buf_(bufferSize ? bufferSize : 1) {}
+
+void FdWriter::write(std::string_view s){
+    if (s.size() > buf_.size() - used_){
+        flush();
+        // Too big to be worth copying: write it straight through
+        if (s.size() >= buf_.size()){ writeAll(s.data(), s.size()); return; }
+    }
+    std::memcpy(buf_.data() + used_, s.data(), s.size());
+    used_ += s.size();
+}
+
+bool FdWriter::flush(){
+    if (used_){
+        writeAll(buf_.data(), used_);
+        used_ = 0;
+    }
+    return !failed_;
+}
+
+void FdWriter::writeAll(const char *data, size_t n){
+    while (n > 0 && !failed_){
+        long long put = sysWrite(fd_, data, n);
+        if (put > 0){ data += put; n -= (size_t)put; continue; }
+        if (put < 0 && errno == EINTR) continue;
+        failed_ = true;
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class FdWriter;
+
+// Line reader on a raw file descriptor with one large buffer: a read() per
+// buffer, never per line or per character, and no iostream machinery. Lines
+// are split like std::getline: at '\n' only, a last line without '\n' counts,
+// a '\r' stays part of the line.
+class FdReader {
+public:
+    static const size_t kDefaultBuffer = 1 << 18;
+
+    explicit FdReader(int fd, size_t bufferSize = kDefaultBuffer);
+
+    // Next line without its '\n'; false at end of input (or on a read error)
+    bool readLine(std::string &line);
+    // Exactly n bytes (a length-prefixed body); false if the input ends first
+    bool read(size_t n, std::string &out);
+    // readLine() can return without waiting: a whole line or the end of input is buffered
+    bool lineReady() const;
+    // Flush `w` before every read() that may block, so output for the lines
+    // already read is not held back while waiting for more (like std::cin.tie).
+    // Several writers can be tied.
+    void tie(FdWriter *w) { tied_.push_back(w); }
+
+    bool failed() const { return failed_; }
+
+private:
+    int fd_;
+    std::vector<char> buf_;
+    size_t begin_ = 0, end_ = 0; // unread bytes are buf_[begin_, end_)
+    bool eof_ = false, failed_ = false;
+    std::vector<FdWriter *> tied_;
+
+    bool fill();
+};
+
+// Buffered writer on a raw file descriptor: output is collected and handed to
+// write() in buffer-sized pieces; nothing is flushed per line.
+class FdWriter {
+public:
+    static const size_t kDefaultBuffer = 1 << 18;
+
+    explicit FdWriter(int fd, size_t bufferSize = kDefaultBuffer);
+    ~FdWriter() { flush(); }
+    FdWriter(const FdWriter &) = delete;
+    FdWriter &operator=(const FdWriter &) = delete;
+
+    void write(std::string_view s);
+    void writeLine(std::string_view s) { write(s); put('\n'); }
+    void put(char c){
+        if (used_ == buf_.size()) flush();
+        buf_[used_++] = c;
+    }
+    // Hand everything buffered to the fd; false once any write failed
+    bool flush();
+
+    bool failed() const { return failed_; }
+
+private:
+    int fd_;
+    std::vector<char> buf_;
+    size_t used_ = 0;
+    bool failed_ = false;
+
+    void writeAll(const char *data, size_t n);
+};
@@ -0,0 +1,98 @@
+#include "IncrementalSession.h"
+#include <algorithm>
+#include <iterator>
+
+// 64-bit FNV-1a
+static uint64_t hashLine(const std::string &s){
+    uint64_t h = 14695981039346656037ull;
+    for (unsigned char c : s){ h ^= c; h *= 1099511628211ull; }
+    return h;
+}
+
+void IncrementalSession::reset(){
+    lines_.clear();
+    snapshots_.clear();
+    end_ = {};
+    valid_ = false;
+}
+
+void IncrementalSession::resume(const std::vector<std::string> &lines, size_t start){
+    const Analyzer::LineState &state = start < lines_.size() ? lines_[start].before : end_;
+    auto snap = std::prev(snapshots_.upper_bound(start));
+    an_.restoreLineState(state, &snap->second);
+    for (size_t k=snap->first; k<start; ++k){
+        an_.replayScopes(lines[k]);
+        ++stats_.replayed;
+    }
+}
+
+std::vector<std::string> IncrementalSession::process(const std::vector<std::string> &lines, std::vector<std::string> &fileIssues){
+    stats_ = {};
+    if (an_.issueNames().size() >= kMaxIssueNames) valid_ = false;
+    const size_t n = lines.size(), old = valid_ ? lines_.size() : 0;
+    std::vector<uint64_t> hashes(n);
+    for (size_t j=0; j<n; ++j) hashes[j] = hashLine(lines[j]);
+
+    // Lines unchanged since the last run, at the start and at the end
+    size_t prefix = 0, suffix = 0;
+    if (valid_){
+        while (prefix < n && prefix < old && hashes[prefix] == lines_[prefix].hash) ++prefix;
+        while (suffix < std::min(n, old) - prefix && hashes[n - 1 - suffix] == lines_[old - 1 - suffix].hash) ++suffix;
+    }
+
+    bool unchanged = valid_ && prefix == n && n == old;
+    if (!valid_){
+        an_.resetFileState();
+        snapshots_.clear();
+        // resume() needs a snapshot at or before any line, even after a 0-line run
+        snapshots_[0] = an_.symbols();
+    } else if (!unchanged){
+        resume(lines, prefix);
+    }
+
+    std::vector<LineRecord> recs(n);
+    for (size_t j=0; j<prefix; ++j) recs[j] = std::move(lines_[j]);
+    std::map<size_t, SymbolTable> oldSnapshots;
+    oldSnapshots.swap(snapshots_);
+    for (auto it = oldSnapshots.begin(); it != oldSnapshots.end() && it->first <= prefix; ++it) snapshots_.insert(std::move(*it));
+
+    bool resynced = unchanged;
+    for (size_t j=prefix; j<n && !resynced; ++j){
+        // In the unchanged suffix, the same text from the same state gives the
+        // same results all the way down
+        if (valid_ && j >= n - suffix){
+            size_t oj = j + old - n;
+            if (an_.lineState() == lines_[oj].before){
+                snapshots_[j] = an_.symbols();
+                for (auto it = oldSnapshots.lower_bound(oj + 1); it != oldSnapshots.end(); ++it) snapshots_[it->first + j - oj] = std::move(it->second);
+                for (size_t m=j; m<n; ++m){
+                    recs[m] = std::move(lines_[m + old - n]);
+                    // Lines above moved: the records carry their line number (the text does not)
+                    for (auto &issue : recs[m].records) issue.line = (uint32_t)(m + 1);
+                }
+                resynced = true;
+                break;
+            }
+        }
+        if (j % kSnapshotEvery == 0) snapshots_[j] = an_.symbols();
+        LineRecord &rec = recs[j];
+        rec.hash = hashes[j];
+        rec.before = an_.lineState();
+        auto r = an_.processLine(lines[j], j + 1);
+        rec.corrected = std::move(r.corrected);
+        rec.issues = std::move(r.issues);
+        rec.records = std::move(r.records);
+        ++stats_.rerun;
+    }
+    if (!resynced) end_ = an_.lineState();
+    stats_.reused = n - stats_.rerun;
+    lines_ = std::move(recs);
+    valid_ = true;
+
+    std::vector<std::string> out;
+    out.reserve(n);
+    for (const auto &rec : lines_) out.push_back(rec.corrected);
+    an_.restoreLineState(end_);
+    an_.finalizeFile(out, fileIssues);
+    return out;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include "SymbolTable.h"
+#include "Utils.h"
+
+// Re-fixes a file that is edited and re-run repeatedly, redoing only the lines
+// an edit can affect. Every line keeps the hash of its text and the Analyzer
+// state it started from. A run reuses the unchanged prefix, re-runs from the
+// first changed line, and stops re-running as soon as a line of the unchanged
+// suffix starts from the same state as last time: from there on every result
+// is the old one (shifted by the number of inserted/removed lines).
+//
+// Results are the same as Analyzer::processFile on the whole file. Reused
+// lines are not written to the Analyzer's log again. Call reset() after
+// changing the Analyzer's pass configuration or dictionary.
+class IncrementalSession {
+public:
+    // The symbol table is snapshotted every kSnapshotEvery lines; resuming
+    // mid-file replays the scopes of at most that many lines
+    static const size_t kSnapshotEvery = 256;
+    // Reused records keep the words their issues quote interned in the
+    // Analyzer; past this many a run starts over so the interner is cleared
+    static const size_t kMaxIssueNames = 1 << 16;
+
+    explicit IncrementalSession(Analyzer &analyzer) : an_(analyzer) {}
+
+    // Fix the whole file, like processFile; fileIssues get the end-of-file issues
+    std::vector<std::string> process(const std::vector<std::string> &lines, std::vector<std::string> &fileIssues);
+
+    // Messages for line i (0-based) of the last process() call
+    const std::vector<std::string> &lineIssues(size_t i) const { return lines_[i].issues; }
+    // The same issues as records (codes, columns), one per lineIssues entry when formatting is on
+    const std::vector<Issue> &lineRecords(size_t i) const { return lines_[i].records; }
+    // Fixed text of line i (0-based) of the last process() call
+    const std::string &lineFixed(size_t i) const { return lines_[i].corrected; }
+
+    struct Stats {
+        size_t reused = 0;   // results taken from the previous run
+        size_t rerun = 0;    // lines fixed again
+        size_t replayed = 0; // lines whose scopes were replayed to rebuild the symbol table
+    };
+    const Stats &lastStats() const { return stats_; }
+
+    void reset();
+
+private:
+    struct LineRecord {
+        uint64_t hash = 0;
+        Analyzer::LineState before; // state the line was processed with
+        std::string corrected;
+        std::vector<std::string> issues;
+        std::vector<Issue> records;
+    };
+
+    Analyzer &an_;
+    std::vector<LineRecord> lines_;
+    Analyzer::LineState end_;                 // state after the last line
+    std::map<size_t, SymbolTable> snapshots_; // symbol table before line i
+    bool valid_ = false;
+    Stats stats_;
+
+    // Put the Analyzer in the state it had before line `start` of the last run
+    void resume(const std::vector<std::string> &lines, size_t start);
+};
@@ -0,0 +1,26 @@
+#include "Interner.h"
+
+Interner::Interner(){
+    strings_.emplace_back();
+    ids_.emplace(std::string_view(strings_.back()), 0);
+}
+
+uint32_t Interner::intern(std::string_view s){
+    auto it = ids_.find(s);
+    if (it != ids_.end()) return it->second;
+    uint32_t id = (uint32_t)strings_.size();
+    strings_.emplace_back(s);
+    ids_.emplace(std::string_view(strings_.back()), id);
+    return id;
+}
+
+int64_t Interner::find(std::string_view s) const {
+    auto it = ids_.find(s);
+    return it == ids_.end() ? -1 : (int64_t)it->second;
+}
+
+void Interner::clear(){
+    ids_.clear();
+    strings_.resize(1);
+    ids_.emplace(std::string_view(strings_.front()), 0);
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Maps strings to small dense ids (and back). Id 0 is always the empty string.
+// Interned strings never move, so ids and the references str() returns stay
+// valid until clear(). Not thread-safe: use one per thread.
+class Interner {
+public:
+    Interner();
+
+    Interner(const Interner &) = delete;
+    Interner &operator=(const Interner &) = delete;
+
+    uint32_t intern(std::string_view s);
+    // Id of s, or -1 if it was never interned
+    int64_t find(std::string_view s) const;
+    const std::string &str(uint32_t id) const { return strings_[id]; }
+    size_t size() const { return strings_.size(); }
+    // Forget every string but the empty one; all other ids become invalid
+    void clear();
+
+private:
+    std::deque<std::string> strings_;                     // stable storage
+    std::unordered_map<std::string_view, uint32_t> ids_;  // views into strings_
+};
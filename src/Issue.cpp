@@ -0,0 +1,29 @@
+#include "Issue.h"
+
+std::string formatIssue(const Issue &issue, const Interner &names){
+    const std::string &a = names.str(issue.a);
+    const std::string &b = names.str(issue.b);
+    switch (issue.code){
+    case IssueCode::NOTE: return a;
+    case IssueCode::INCLUDE_HASH_ADDED: return "added missing '#' before include";
+    case IssueCode::INCLUDE_ANGLE_CLOSED: return "inserted missing '>' in #include<...>";
+    case IssueCode::IDENTIFIER: return "identifier '" + a + "' -> '" + b + "'";
+    case IssueCode::SPLIT_INT: return "split '" + a + "' -> 'int " + b + "'";
+    case IssueCode::FOR_COMMA: return "for(...) comma -> semicolon";
+    case IssueCode::FOR_FIRST_SEMICOLON: return "for(...) inserted first semicolon after init";
+    case IssueCode::FOR_SECOND_SEMICOLON: return "for(...) inserted second semicolon after condition";
+    case IssueCode::FOR_MISSING_SEMICOLON: return "for(...) inserted missing second semicolon";
+    case IssueCode::COUT_OPERATOR: return "stream operator '" + a + "' -> '<<' in cout chain";
+    case IssueCode::CIN_OPERATOR: return "stream operator '" + a + "' -> '>>' in cin chain";
+    case IssueCode::CHAR_LITERAL: return "invalid char literal '" + a + "' -> \"" + b + "\" (multi-char needs double quotes)";
+    case IssueCode::MISSING_SEMICOLON: return "added missing semicolon";
+    case IssueCode::UNMATCHED_BRACE: return "unmatched '}' removed or extra";
+    case IssueCode::UNMATCHED_PAREN: return "unmatched ')' detected";
+    case IssueCode::UNMATCHED_BRACKET: return "unmatched ']' detected";
+    case IssueCode::AUTO_INDENT: return "auto-indented";
+    case IssueCode::EOF_BRACE_INSERTED: return "inserted missing closing '}' at end of file";
+    case IssueCode::EOF_MISSING_PAREN: return "missing ')' at end of file";
+    case IssueCode::EOF_MISSING_BRACKET: return "missing ']' at end of file";
+    }
+    return a;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Interner.h"
+
+// Kinds of issues the fix passes and brace checks report. Each code has one
+// message template; the words it quotes are stored as interned ids (a, b).
+enum class IssueCode : uint8_t {
+    NOTE,                    // free text: a
+    INCLUDE_HASH_ADDED,      // added missing '#' before include
+    INCLUDE_ANGLE_CLOSED,    // inserted missing '>' in #include<...>
+    IDENTIFIER,              // identifier 'a' -> 'b'
+    SPLIT_INT,               // split 'a' -> 'int b'
+    FOR_COMMA,               // for(...) comma -> semicolon
+    FOR_FIRST_SEMICOLON,     // for(...) inserted first semicolon after init
+    FOR_SECOND_SEMICOLON,    // for(...) inserted second semicolon after condition
+    FOR_MISSING_SEMICOLON,   // for(...) inserted missing second semicolon
+    COUT_OPERATOR,           // stream operator 'a' -> '<<' in cout chain
+    CIN_OPERATOR,            // stream operator 'a' -> '>>' in cin chain
+    CHAR_LITERAL,            // invalid char literal 'a' -> "b" (multi-char needs double quotes)
+    MISSING_SEMICOLON,       // added missing semicolon
+    UNMATCHED_BRACE,         // unmatched '}' removed or extra
+    UNMATCHED_PAREN,         // unmatched ')' detected
+    UNMATCHED_BRACKET,       // unmatched ']' detected
+    AUTO_INDENT,             // auto-indented
+    EOF_BRACE_INSERTED,      // inserted missing closing '}' at end of file
+    EOF_MISSING_PAREN,       // missing ')' at end of file
+    EOF_MISSING_BRACKET,     // missing ']' at end of file
+};
+
+// One reported issue. Recording it formats nothing; the words it quotes are
+// interned, so a repeated typo costs no allocation.
+struct Issue {
+    IssueCode code = IssueCode::NOTE;
+    uint32_t line = 0;    // 1-based, set when the line is finished
+    uint32_t column = 0;  // 1-based byte column in the original line; 0 = whole line
+    uint32_t a = 0, b = 0;
+};
+
+// Issues plus the interner their word ids refer to
+class IssueList {
+public:
+    explicit IssueList(Interner *names = nullptr) : names_(names) {}
+
+    void bind(Interner *names) { names_ = names; }
+    Interner *names() const { return names_; }
+
+    void add(IssueCode code, uint32_t column = 0, std::string_view a = {}, std::string_view b = {}){
+        items_.push_back({code, 0, column, a.empty() ? 0 : names_->intern(a), b.empty() ? 0 : names_->intern(b)});
+    }
+    void push_back(const Issue &issue) { items_.push_back(issue); }
+
+    size_t size() const { return items_.size(); }
+    bool empty() const { return items_.empty(); }
+    void clear() { items_.clear(); }
+    Issue &operator[](size_t i) { return items_[i]; }
+    const Issue &operator[](size_t i) const { return items_[i]; }
+    std::vector<Issue>::iterator begin() { return items_.begin(); }
+    std::vector<Issue>::iterator end() { return items_.end(); }
+    std::vector<Issue>::const_iterator begin() const { return items_.begin(); }
+    std::vector<Issue>::const_iterator end() const { return items_.end(); }
+    std::vector<Issue> &items() { return items_; }
+
+private:
+    std::vector<Issue> items_;
+    Interner *names_;
+};
+
+// Human-readable message (the text LineResult::issues has always carried)
+std::string formatIssue(const Issue &issue, const Interner &names);
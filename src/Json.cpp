@@ -0,0 +1,280 @@
+#include "Json.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+static const JsonValue kNull;
+static const std::string kEmpty;
+
+JsonValue JsonValue::array(){
+    JsonValue v;
+    v.type_ = Type::Array;
+    return v;
+}
+
+JsonValue JsonValue::object(){
+    JsonValue v;
+    v.type_ = Type::Object;
+    return v;
+}
+
+const std::string &JsonValue::asString() const {
+    return type_ == Type::String ? string_ : kEmpty;
+}
+
+const JsonValue &JsonValue::operator[](std::string_view key) const {
+    for (auto &m : object_) if (m.first == key) return m.second;
+    return kNull;
+}
+
+const JsonValue &JsonValue::operator[](size_t index) const {
+    return index < array_.size() ? array_[index] : kNull;
+}
+
+bool JsonValue::has(std::string_view key) const {
+    for (auto &m : object_) if (m.first == key) return true;
+    return false;
+}
+
+size_t JsonValue::size() const {
+    return type_ == Type::Array ? array_.size() : type_ == Type::Object ? object_.size() : 0;
+}
+
+JsonValue &JsonValue::set(std::string key, JsonValue value){
+    type_ = Type::Object;
+    for (auto &m : object_){
+        if (m.first == key){ m.second = std::move(value); return *this; }
+    }
+    object_.emplace_back(std::move(key), std::move(value));
+    return *this;
+}
+
+JsonValue &JsonValue::push(JsonValue value){
+    type_ = Type::Array;
+    array_.push_back(std::move(value));
+    return *this;
+}
+
+void JsonValue::quote(std::string &out, std::string_view s){
+    static const char hex[] = "0123456789abcdef";
+    out += '"';
+    for (unsigned char c : s){
+        switch (c){
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        case '\b': out += "\\b"; break;
+        case '\f': out += "\\f"; break;
+        default:
+            if (c < 0x20){ out += "\\u00"; out += hex[c >> 4]; out += hex[c & 15]; }
+            else out += (char)c;
+        }
+    }
+    out += '"';
+}
+
+void JsonValue::dump(std::string &out) const {
+    switch (type_){
+    case Type::Null: out += "null"; break;
+    case Type::Bool: out += bool_ ? "true" : "false"; break;
+    case Type::Number: {
+        if (std::isfinite(number_) && number_ == std::floor(number_) && std::fabs(number_) < 9e15){
+            out += std::to_string((long long)number_);
+        } else if (std::isfinite(number_)){
+            char buf[32];
+            std::snprintf(buf, sizeof(buf), "%.17g", number_);
+            out += buf;
+        } else {
+            out += "null";
+        }
+        break;
+    }
+    case Type::String: quote(out, string_); break;
+    case Type::Array:
+        out += '[';
+        for (size_t i=0; i<array_.size(); ++i){
+            if (i) out += ',';
+            array_[i].dump(out);
+        }
+        out += ']';
+        break;
+    case Type::Object:
+        out += '{';
+        for (size_t i=0; i<object_.size(); ++i){
+            if (i) out += ',';
+            quote(out, object_[i].first);
+            out += ':';
+            object_[i].second.dump(out);
+        }
+        out += '}';
+        break;
+    }
+}
+
+std::string JsonValue::dump() const {
+    std::string out;
+    dump(out);
+    return out;
+}
+
+// Recursive descent over the text; depth-limited so hostile input cannot blow the stack
+struct JsonParser {
+    std::string_view s;
+    size_t i = 0;
+    std::string error;
+    static const int kMaxDepth = 256;
+
+    bool fail(const char *what){
+        if (error.empty()) error = std::string(what) + " at offset " + std::to_string(i);
+        return false;
+    }
+    void ws(){ while (i < s.size() && (s[i] == ' ' || s[i] == '\t' || s[i] == '\n' || s[i] == '\r')) ++i; }
+    bool literal(const char *word){
+        size_t n = std::char_traits<char>::length(word);
+        if (s.compare(i, n, word) != 0) return fail("bad literal");
+        i += n;
+        return true;
+    }
+    static void utf8(std::string &out, unsigned cp){
+        if (cp < 0x80) out += (char)cp;
+        else if (cp < 0x800){ out += (char)(0xC0 | (cp >> 6)); out += (char)(0x80 | (cp & 0x3F)); }
+        else if (cp < 0x10000){ out += (char)(0xE0 | (cp >> 12)); out += (char)(0x80 | ((cp >> 6) & 0x3F)); out += (char)(0x80 | (cp & 0x3F)); }
+        else { out += (char)(0xF0 | (cp >> 18)); out += (char)(0x80 | ((cp >> 12) & 0x3F)); out += (char)(0x80 | ((cp >> 6) & 0x3F)); out += (char)(0x80 | (cp & 0x3F)); }
+    }
+    bool hex4(unsigned &v){
+        if (i + 4 > s.size()) return fail("short \\u escape");
+        v = 0;
+        for (int k=0; k<4; ++k){
+            char c = s[i++];
+            v <<= 4;
+            if (c >= '0' && c <= '9') v |= (unsigned)(c - '0');
+            else if (c >= 'a' && c <= 'f') v |= (unsigned)(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') v |= (unsigned)(c - 'A' + 10);
+            else return fail("bad \\u escape");
+        }
+        return true;
+    }
+    bool string(std::string &out){
+        ++i; // opening quote
+        while (true){
+            size_t start = i;
+            while (i < s.size() && s[i] != '"' && s[i] != '\\') ++i;
+            out.append(s.data() + start, i - start);
+            if (i >= s.size()) return fail("unterminated string");
+            if (s[i++] == '"') return true;
+            if (i >= s.size()) return fail("unterminated escape");
+            char c = s[i++];
+            switch (c){
+            case '"': out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/': out += '/'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                unsigned cp = 0;
+                if (!hex4(cp)) return false;
+                // Surrogate pair: combine; a lone surrogate becomes U+FFFD
+                if (cp >= 0xD800 && cp < 0xDC00 && s.compare(i, 2, "\\u") == 0){
+                    size_t save = i;
+                    i += 2;
+                    unsigned lo = 0;
+                    if (!hex4(lo)) return false;
+                    if (lo >= 0xDC00 && lo < 0xE000) cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                    else { i = save; cp = 0xFFFD; }
+                } else if (cp >= 0xD800 && cp < 0xE000){
+                    cp = 0xFFFD;
+                }
+                utf8(out, cp);
+                break;
+            }
+            default: return fail("bad escape");
+            }
+        }
+    }
+    bool value(JsonValue &out, int depth){
+        if (depth > kMaxDepth) return fail("nesting too deep");
+        ws();
+        if (i >= s.size()) return fail("unexpected end");
+        char c = s[i];
+        if (c == '{'){
+            ++i;
+            out = JsonValue::object();
+            ws();
+            if (i < s.size() && s[i] == '}'){ ++i; return true; }
+            while (true){
+                ws();
+                if (i >= s.size() || s[i] != '"') return fail("expected member name");
+                std::string key;
+                if (!string(key)) return false;
+                ws();
+                if (i >= s.size() || s[i] != ':') return fail("expected ':'");
+                ++i;
+                JsonValue v;
+                if (!value(v, depth + 1)) return false;
+                out.object_.emplace_back(std::move(key), std::move(v)); // a duplicate name: the first one wins on lookup
+                ws();
+                if (i < s.size() && s[i] == ','){ ++i; continue; }
+                if (i < s.size() && s[i] == '}'){ ++i; return true; }
+                return fail("expected ',' or '}'");
+            }
+        }
+        if (c == '['){
+            ++i;
+            out = JsonValue::array();
+            ws();
+            if (i < s.size() && s[i] == ']'){ ++i; return true; }
+            while (true){
+                JsonValue v;
+                if (!value(v, depth + 1)) return false;
+                out.push(std::move(v));
+                ws();
+                if (i < s.size() && s[i] == ','){ ++i; continue; }
+                if (i < s.size() && s[i] == ']'){ ++i; return true; }
+                return fail("expected ',' or ']'");
+            }
+        }
+        if (c == '"'){
+            std::string str;
+            if (!string(str)) return false;
+            out = JsonValue(std::move(str));
+            return true;
+        }
+        if (c == 't'){ out = JsonValue(true); return literal("true"); }
+        if (c == 'f'){ out = JsonValue(false); return literal("false"); }
+        if (c == 'n'){ out = JsonValue(); return literal("null"); }
+        if (c == '-' || (c >= '0' && c <= '9')){
+            size_t start = i;
+            if (s[i] == '-') ++i;
+            while (i < s.size() && ((s[i] >= '0' && s[i] <= '9') || s[i] == '.' || s[i] == 'e' || s[i] == 'E' || s[i] == '+' || s[i] == '-')) ++i;
+            std::string num(s.substr(start, i - start));
+            char *end = nullptr;
+            double d = std::strtod(num.c_str(), &end);
+            if (end != num.c_str() + num.size()) return fail("bad number");
+            out = JsonValue(d);
+            return true;
+        }
+        return fail("unexpected character");
+    }
+};
+
+bool JsonValue::parse(std::string_view text, JsonValue &out, std::string *error){
+    JsonParser p;
+    p.s = text;
+    JsonValue v;
+    bool ok = p.value(v, 0);
+    if (ok){
+        p.ws();
+        if (p.i != text.size()) ok = p.fail("trailing characters");
+    }
+    if (!ok){
+        if (error) *error = p.error;
+        return false;
+    }
+    out = std::move(v);
+    return true;
+}
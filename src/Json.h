@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Just enough JSON for the language server: parse a message into a tree, look
+// members up, build replies and serialize them. Objects keep their members in
+// insertion order (LSP objects are small, so lookup is a linear scan). Numbers
+// are doubles, which covers every integer LSP sends.
+class JsonValue {
+public:
+    enum class Type { Null, Bool, Number, String, Array, Object };
+    using Member = std::pair<std::string, JsonValue>;
+
+    JsonValue() = default;
+    JsonValue(std::nullptr_t) {}
+    JsonValue(bool b) : type_(Type::Bool), bool_(b) {}
+    JsonValue(int n) : type_(Type::Number), number_(n) {}
+    JsonValue(size_t n) : type_(Type::Number), number_((double)n) {}
+    JsonValue(double n) : type_(Type::Number), number_(n) {}
+    JsonValue(std::string s) : type_(Type::String), string_(std::move(s)) {}
+    JsonValue(const char *s) : type_(Type::String), string_(s) {}
+
+    static JsonValue array();
+    static JsonValue object();
+
+    // Parse one complete JSON text; false (with a message) on malformed input
+    static bool parse(std::string_view text, JsonValue &out, std::string *error = nullptr);
+
+    Type type() const { return type_; }
+    bool isNull() const { return type_ == Type::Null; }
+    bool isString() const { return type_ == Type::String; }
+    bool isNumber() const { return type_ == Type::Number; }
+    bool isArray() const { return type_ == Type::Array; }
+    bool isObject() const { return type_ == Type::Object; }
+
+    // Accessors fall back to the given default on a type mismatch
+    bool asBool(bool def = false) const { return type_ == Type::Bool ? bool_ : def; }
+    double asNumber(double def = 0) const { return type_ == Type::Number ? number_ : def; }
+    long long asInt(long long def = 0) const { return type_ == Type::Number ? (long long)number_ : def; }
+    const std::string &asString() const;
+
+    // Object member or array element; a shared null value when missing
+    const JsonValue &operator[](std::string_view key) const;
+    const JsonValue &operator[](size_t index) const;
+    bool has(std::string_view key) const;
+    size_t size() const;                       // array elements or object members
+    const std::vector<JsonValue> &elements() const { return array_; }
+    const std::vector<Member> &members() const { return object_; }
+
+    // Builders: set replaces an existing member
+    JsonValue &set(std::string key, JsonValue value);
+    JsonValue &push(JsonValue value);
+
+    std::string dump() const;
+    void dump(std::string &out) const;
+    // Append s as a quoted JSON string
+    static void quote(std::string &out, std::string_view s);
+
+private:
+    friend struct JsonParser;
+    Type type_ = Type::Null;
+    bool bool_ = false;
+    double number_ = 0;
+    std::string string_;
+    std::vector<JsonValue> array_;
+    std::vector<Member> object_;
+};
@@ -1,8 +1,12 @@
 #include "Logger.h"
 #include <filesystem>
 
+// The writer hands a batch to the streams once it grows past this
+static const size_t kBatchBytes = 1 << 16;
+
 Logger::Logger() {}
 Logger::~Logger() {
+    stopAsync();
     flush();
 }
 
@@ -22,29 +26,178 @@ bool Logger::init(const std::string &dir) {
     if (analysisOut_.is_open()) {
         analysisOut_ << "\n==== IntelliFix++ session started ====" << "\n";
     }
+    open_ = fixesOut_.is_open();
+    analysisOpen_ = analysisOut_.is_open();
     return fixesOut_.is_open() && analysisOut_.is_open();
 }
 
+// Same text in both modes; the async writer just builds it on its own thread
+static void appendIssue(std::string &out, size_t lineNo, const std::string &message) {
+    out += "[Issue] line " + std::to_string(lineNo) + ": ";
+    out += message;
+    out += "\n";
+}
+
+static void appendFix(std::string &out, size_t lineNo, const std::string &original, const std::string &corrected, const std::string &message) {
+    out += "[Fix] line " + std::to_string(lineNo) + ": ";
+    out += message;
+    out += "\n  - before: ";
+    out += original;
+    out += "\n  + after : ";
+    out += corrected;
+    out += "\n";
+}
+
+static void appendLines(std::string &out, const std::vector<std::string> &lines) {
+    for (const auto &l : lines) { out += l; out += "\n"; }
+}
+
+void Logger::format(std::string &fixes, std::string &analysis, const Record &r) {
+    switch (r.kind) {
+    case Record::ISSUE: appendIssue(fixes, r.lineNo, r.message); break;
+    case Record::FIX: appendFix(fixes, r.lineNo, r.original, r.corrected, r.message); break;
+    case Record::ANALYSIS: appendLines(analysis, r.lines); break;
+    case Record::BARRIER: break;
+    }
+}
+
+void Logger::write(std::string &fixes, std::string &analysis) {
+    if (fixesOut_.is_open() && !fixes.empty()) fixesOut_.write(fixes.data(), (std::streamsize)fixes.size());
+    if (analysisOut_.is_open() && !analysis.empty()) analysisOut_.write(analysis.data(), (std::streamsize)analysis.size());
+    fixes.clear();
+    analysis.clear();
+}
+
 void Logger::issue(size_t lineNo, const std::string &message) {
-    if (fixesOut_.is_open()) {
-        fixesOut_ << "[Issue] line " << lineNo << ": " << message << "\n";
+    if (!open_) return;
+    if (!ring_) {
+        std::string text;
+        appendIssue(text, lineNo, message);
+        fixesOut_ << text;
+        return;
     }
+    Record r;
+    r.kind = Record::ISSUE;
+    r.lineNo = lineNo;
+    r.message = message;
+    enqueue(r, false);
 }
 
 void Logger::fix(size_t lineNo, const std::string &original, const std::string &corrected, const std::string &message) {
-    if (fixesOut_.is_open()) {
-        fixesOut_ << "[Fix] line " << lineNo << ": " << message << "\n"
-                  << "  - before: " << original << "\n"
-                  << "  + after : " << corrected << "\n";
+    if (!open_) return;
+    if (!ring_) {
+        std::string text;
+        appendFix(text, lineNo, original, corrected, message);
+        fixesOut_ << text;
+        return;
     }
+    Record r;
+    r.kind = Record::FIX;
+    r.lineNo = lineNo;
+    r.message = message;
+    r.original = original;
+    r.corrected = corrected;
+    enqueue(r, false);
 }
 
 void Logger::writeAnalysis(const std::vector<std::string> &lines) {
-    if (!analysisOut_.is_open()) return;
-    for (const auto &l : lines) analysisOut_ << l << "\n";
+    if (!analysisOpen_) return;
+    if (!ring_) {
+        for (const auto &l : lines) analysisOut_ << l << "\n";
+        return;
+    }
+    Record r;
+    r.kind = Record::ANALYSIS;
+    r.lines = lines;
+    enqueue(r, false);
 }
 
 void Logger::flush() {
+    if (ring_) { wake(); return; }
     if (fixesOut_.is_open()) fixesOut_.flush();
     if (analysisOut_.is_open()) analysisOut_.flush();
 }
+
+bool Logger::startAsync(const AsyncLogOptions &opts) {
+    if (ring_ || !open_) return false;
+    async_ = opts;
+    if (async_.flushInterval.count() <= 0) async_.flushInterval = std::chrono::milliseconds(1);
+    ring_.reset(new MpscRing<Record>(async_.capacity));
+    stop_ = false;
+    writer_ = std::thread([this] { writerLoop(); });
+    return true;
+}
+
+void Logger::stopAsync() {
+    if (!ring_) return;
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        stop_ = true;
+    }
+    wake_.notify_one();
+    writer_.join();
+    ring_.reset();
+    flush();
+}
+
+void Logger::drain() {
+    if (!ring_) { flush(); return; }
+    std::promise<void> done;
+    std::future<void> written = done.get_future();
+    Record r;
+    r.kind = Record::BARRIER;
+    r.done = &done;
+    enqueue(r, true);
+    wake();
+    written.wait();
+}
+
+void Logger::enqueue(Record &r, bool keep) {
+    while (!ring_->tryPush(r)) {
+        if (!keep && async_.whenFull == LogFullPolicy::Drop) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        wake();
+        std::this_thread::yield();
+    }
+    // Do not let the ring fill up waiting for the interval
+    if (ring_->sizeApprox() >= ring_->capacity() / 2) wake();
+}
+
+void Logger::wake() {
+    // One notification per writer round; the flag is cleared when the writer wakes
+    if (wakePending_.exchange(true, std::memory_order_acq_rel)) return;
+    { std::lock_guard<std::mutex> lock(m_); }
+    wake_.notify_one();
+}
+
+void Logger::writerLoop() {
+    std::string fixes, analysis;
+    std::vector<std::promise<void> *> barriers;
+    Record r;
+    while (true) {
+        bool stopping;
+        {
+            std::unique_lock<std::mutex> lock(m_);
+            wake_.wait_for(lock, async_.flushInterval, [&] { return stop_ || wakePending_.load(std::memory_order_acquire); });
+            wakePending_.store(false, std::memory_order_release);
+            stopping = stop_;
+        }
+        bool wrote = false;
+        while (ring_->tryPop(r)) {
+            if (r.kind == Record::BARRIER) barriers.push_back(r.done);
+            format(fixes, analysis, r);
+            wrote = true;
+            if (fixes.size() + analysis.size() >= kBatchBytes) write(fixes, analysis);
+        }
+        if (wrote) {
+            write(fixes, analysis);
+            if (fixesOut_.is_open()) fixesOut_.flush();
+            if (analysisOut_.is_open()) analysisOut_.flush();
+        }
+        for (auto *b : barriers) b->set_value();
+        barriers.clear();
+        if (stopping) break;
+    }
+}
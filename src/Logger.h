@@ -1,13 +1,37 @@
 #pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <fstream>
+#include <thread>
 #include <vector>
+#include "MpscRing.h"
+
+// What asynchronous logging does when its ring buffer is full
+enum class LogFullPolicy {
+    Block, // the caller waits for the writer: nothing is lost
+    Drop   // the record is discarded and counted: logging never stalls the caller
+};
+
+struct AsyncLogOptions {
+    size_t capacity = 8192;                          // records the ring holds
+    std::chrono::milliseconds flushInterval{100};    // longest a record waits to be written
+    LogFullPolicy whenFull = LogFullPolicy::Block;
+};
 
 class Logger {
 public:
     Logger();
     ~Logger();
 
+    Logger(const Logger &) = delete;
+    Logger &operator=(const Logger &) = delete;
+
     // Initialize log files under a directory (creates/overwrites)
     bool init(const std::string &dir);
 
@@ -24,12 +48,57 @@ public:
     std::string analysisPath() const { return analysisPath_; }
     std::string fixesPath() const { return fixesPath_; }
 
+    // Synchronous mode: flush the files. Asynchronous mode: ask the writer to
+    // write out what is queued now, without waiting for it.
     void flush();
 
+    // Asynchronous mode (after init): issue/fix/writeAnalysis only queue a
+    // record in a lock-free ring and return; a background thread formats the
+    // records and writes them in large batches, at the latest every
+    // flushInterval. In this mode the logging calls may come from any number
+    // of threads at once. False if the files are not open or already async.
+    // Start and stop while no other thread is logging.
+    bool startAsync(const AsyncLogOptions &opts = AsyncLogOptions());
+    // Write everything queued, stop the writer and return to synchronous mode
+    void stopAsync();
+    // Block until every record logged before the call is written and flushed
+    void drain();
+
+    bool isAsync() const { return ring_ != nullptr; }
+    // Records discarded under LogFullPolicy::Drop
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    // False until init() succeeded; callers can skip building messages then
+    bool isOpen() const { return open_; }
+
 private:
+    struct Record {
+        enum Kind : unsigned char { ISSUE, FIX, ANALYSIS, BARRIER } kind = ISSUE;
+        size_t lineNo = 0;
+        std::string message, original, corrected;
+        std::vector<std::string> lines;  // ANALYSIS
+        std::promise<void> *done = nullptr; // BARRIER: set once written
+    };
+
     std::ofstream fixesOut_;
     std::ofstream analysisOut_;
     std::string baseDir_;
     std::string analysisPath_;
     std::string fixesPath_;
+    bool open_ = false, analysisOpen_ = false; // set by init; read by logging threads
+
+    AsyncLogOptions async_;
+    std::unique_ptr<MpscRing<Record>> ring_;
+    std::thread writer_;
+    std::mutex m_;
+    std::condition_variable wake_;
+    std::atomic<bool> wakePending_{false};
+    std::atomic<uint64_t> dropped_{0};
+    bool stop_ = false;
+
+    static void format(std::string &fixes, std::string &analysis, const Record &r);
+    void write(std::string &fixes, std::string &analysis);
+    void enqueue(Record &r, bool keep);
+    void wake();
+    void writerLoop();
 };
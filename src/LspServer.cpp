@@ -0,0 +1,302 @@
+#include "LspServer.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include "FastIO.h"
+#include "Utf8.h"
+
+// JSON-RPC error codes used here
+static const int kParseError = -32700;
+static const int kInvalidRequest = -32600;
+static const int kMethodNotFound = -32601;
+static const int kInvalidParams = -32602;
+static const int kServerNotInitialized = -32002;
+
+// LSP DiagnosticSeverity
+static int severityOf(IssueCode code){
+    switch (code){
+    case IssueCode::AUTO_INDENT: return 4; // hint
+    case IssueCode::UNMATCHED_BRACE:
+    case IssueCode::UNMATCHED_PAREN:
+    case IssueCode::UNMATCHED_BRACKET: return 1; // error
+    default: return 2; // warning
+    }
+}
+
+static size_t utf16Size(const std::string &s){ return utf16Length(s.data(), s.size()); }
+
+static JsonValue position(size_t line, size_t character){
+    return JsonValue::object().set("line", line).set("character", character);
+}
+
+static JsonValue range(size_t line, size_t startChar, size_t endLine, size_t endChar){
+    return JsonValue::object().set("start", position(line, startChar)).set("end", position(endLine, endChar));
+}
+
+LspServer::LspServer(){
+    trie_.loadDefaultDictionary();
+}
+
+bool LspServer::setPasses(const std::string &spec, std::string *error){
+    SymbolTable sym; Logger log;
+    Analyzer probe(trie_, sym, log);
+    if (!probe.configurePasses(spec, error)) return false;
+    passes_ = spec;
+    return true;
+}
+
+void LspServer::splitText(const std::string &text, std::vector<std::string> &lines){
+    lines.clear();
+    size_t start = 0;
+    while (true){
+        size_t nl = text.find('\n', start);
+        size_t end = nl == std::string::npos ? text.size() : nl;
+        size_t len = end - start;
+        if (nl != std::string::npos && len > 0 && text[end - 1] == '\r') --len; // CRLF is one line break
+        lines.emplace_back(text, start, len);
+        if (nl == std::string::npos) break;
+        start = nl + 1;
+    }
+}
+
+void LspServer::applyEdit(std::vector<std::string> &lines, size_t startLine, size_t startChar,
+                          size_t endLine, size_t endChar, const std::string &text){
+    if (lines.empty()) lines.emplace_back();
+    // Positions past the end clamp to the end of the document
+    auto clamp = [&](size_t &line, size_t &ch){
+        if (line >= lines.size()){ line = lines.size() - 1; ch = utf16Size(lines[line]); }
+    };
+    clamp(startLine, startChar);
+    clamp(endLine, endChar);
+    if (endLine < startLine || (endLine == startLine && endChar < startChar)){ endLine = startLine; endChar = startChar; }
+    const std::string &first = lines[startLine], &last = lines[endLine];
+    std::string prefix = first.substr(0, utf16ToByteOffset(first.data(), first.size(), startChar));
+    std::string suffix = last.substr(utf16ToByteOffset(last.data(), last.size(), endChar));
+
+    std::vector<std::string> pieces;
+    splitText(text, pieces);
+    pieces.front().insert(0, prefix);
+    pieces.back() += suffix;
+
+    // Overwrite the replaced lines in place, then insert or erase the difference
+    size_t replaced = endLine - startLine + 1, common = std::min(replaced, pieces.size());
+    for (size_t k=0; k<common; ++k) lines[startLine + k] = std::move(pieces[k]);
+    if (pieces.size() > replaced){
+        lines.insert(lines.begin() + startLine + replaced, std::make_move_iterator(pieces.begin() + replaced),
+                     std::make_move_iterator(pieces.end()));
+    } else if (pieces.size() < replaced){
+        lines.erase(lines.begin() + startLine + common, lines.begin() + startLine + replaced);
+    }
+}
+
+const std::vector<std::string> *LspServer::documentLines(const std::string &uri) const {
+    auto it = docs_.find(uri);
+    return it == docs_.end() ? nullptr : &it->second->lines;
+}
+
+std::string LspServer::reply(const JsonValue &id, JsonValue result){
+    return JsonValue::object().set("jsonrpc", "2.0").set("id", id).set("result", std::move(result)).dump();
+}
+
+std::string LspServer::error(const JsonValue &id, int code, const std::string &message){
+    return JsonValue::object().set("jsonrpc", "2.0").set("id", id)
+        .set("error", JsonValue::object().set("code", code).set("message", message)).dump();
+}
+
+void LspServer::analyze(const std::string &uri, Document &doc, std::vector<std::string> &out){
+    doc.fileIssues.clear();
+    doc.fixed = doc.session->process(doc.lines, doc.fileIssues);
+    lastRerun_ = doc.session->lastStats().rerun;
+    out.push_back(diagnostics(uri, doc));
+}
+
+// Written straight into one string: a large file can carry thousands of
+// diagnostics and this runs on every keystroke
+std::string LspServer::diagnostics(const std::string &uri, const Document &doc) const {
+    std::string out = "{\"jsonrpc\":\"2.0\",\"method\":\"textDocument/publishDiagnostics\",\"params\":{\"uri\":";
+    JsonValue::quote(out, uri);
+    out += ",\"version\":" + std::to_string(doc.version) + ",\"diagnostics\":[";
+    bool first = true;
+    auto add = [&](size_t line, size_t from, size_t to, int severity, const std::string &message){
+        if (!first) out += ',';
+        first = false;
+        std::string ln = std::to_string(line);
+        out += "{\"range\":{\"start\":{\"line\":" + ln + ",\"character\":" + std::to_string(from)
+             + "},\"end\":{\"line\":" + ln + ",\"character\":" + std::to_string(to)
+             + "}},\"severity\":" + std::to_string(severity) + ",\"source\":\"intellifix\",\"message\":";
+        JsonValue::quote(out, message);
+        out += '}';
+    };
+    for (size_t i=0; i<doc.lines.size(); ++i){
+        const auto &issues = doc.session->lineIssues(i);
+        if (issues.empty()) continue;
+        const auto &records = doc.session->lineRecords(i);
+        const std::string &text = doc.lines[i];
+        size_t width = utf16Size(text);
+        for (size_t k=0; k<issues.size(); ++k){
+            size_t from = 0;
+            int severity = 2;
+            if (k < records.size()){
+                severity = severityOf(records[k].code);
+                size_t col = records[k].column;
+                if (col > 0) from = utf16Length(text.data(), std::min(text.size(), (size_t)col - 1));
+            }
+            add(i, from, width, severity, issues[k]);
+        }
+    }
+    // End-of-file issues sit at the end of the last line
+    size_t last = doc.lines.empty() ? 0 : doc.lines.size() - 1;
+    size_t end = doc.lines.empty() ? 0 : utf16Size(doc.lines.back());
+    for (auto &msg : doc.fileIssues) add(last, end, end, 2, msg);
+    out += "]}}";
+    return out;
+}
+
+JsonValue LspServer::codeActions(const std::string &uri, const Document &doc, size_t firstLine, size_t lastLine) const {
+    JsonValue actions = JsonValue::array();
+    auto lineEdit = [&](size_t i){
+        return JsonValue::object().set("range", range(i, 0, i, utf16Size(doc.lines[i]))).set("newText", doc.fixed[i]);
+    };
+    auto action = [&](const std::string &title, const char *kind, JsonValue edits){
+        return JsonValue::object().set("title", title).set("kind", kind)
+            .set("edit", JsonValue::object().set("changes", JsonValue::object().set(uri, std::move(edits))));
+    };
+
+    JsonValue all = JsonValue::array();
+    for (size_t i=0; i<doc.lines.size() && i<doc.fixed.size(); ++i){
+        if (doc.fixed[i] == doc.lines[i]) continue;
+        all.push(lineEdit(i));
+        if (i < firstLine || i > lastLine) continue;
+        const auto &issues = doc.session->lineIssues(i);
+        std::string title = "IntelliFix: " + (issues.empty() ? std::string("apply correction") : issues.front());
+        actions.push(action(title, "quickfix", JsonValue::array().push(lineEdit(i))));
+    }
+    // Lines the fixer appends (missing '}') go after the last line
+    if (doc.fixed.size() > doc.lines.size()){
+        std::string tail;
+        for (size_t i=doc.lines.size(); i<doc.fixed.size(); ++i) tail += "\n" + doc.fixed[i];
+        size_t last = doc.lines.size() - 1, end = utf16Size(doc.lines.back());
+        all.push(JsonValue::object().set("range", range(last, end, last, end)).set("newText", tail));
+    }
+    if (all.size()) actions.push(action("IntelliFix: fix all", "source.fixAll", std::move(all)));
+    return actions;
+}
+
+void LspServer::handle(const std::string &message, std::vector<std::string> &out){
+    JsonValue msg;
+    std::string parseError;
+    if (!JsonValue::parse(message, msg, &parseError) || !msg.isObject()){
+        out.push_back(error(JsonValue(), kParseError, parseError.empty() ? "not an object" : parseError));
+        return;
+    }
+    const std::string &method = msg["method"].asString();
+    const bool isRequest = msg.has("id");
+    const JsonValue &id = msg["id"];
+    const JsonValue &params = msg["params"];
+
+    if (method == "exit"){ exit_ = true; return; }
+    if (!initialized_ && method != "initialize"){
+        if (isRequest) out.push_back(error(id, kServerNotInitialized, "initialize first"));
+        return;
+    }
+    if (shutdown_){
+        if (isRequest) out.push_back(error(id, kInvalidRequest, "server is shutting down"));
+        return;
+    }
+
+    if (method == "initialize"){
+        initialized_ = true;
+        JsonValue caps = JsonValue::object()
+            .set("positionEncoding", "utf-16")
+            .set("textDocumentSync", JsonValue::object().set("openClose", true).set("change", 2))
+            .set("codeActionProvider", JsonValue::object().set("codeActionKinds", JsonValue::array().push("quickfix").push("source.fixAll")));
+        out.push_back(reply(id, JsonValue::object().set("capabilities", std::move(caps))
+                                    .set("serverInfo", JsonValue::object().set("name", "intellifix"))));
+    } else if (method == "shutdown"){
+        shutdown_ = true;
+        out.push_back(reply(id, JsonValue()));
+    } else if (method == "textDocument/didOpen"){
+        const JsonValue &td = params["textDocument"];
+        const std::string &uri = td["uri"].asString();
+        auto doc = std::make_unique<Document>();
+        doc->version = td["version"].asInt();
+        splitText(td["text"].asString(), doc->lines);
+        doc->an = std::make_unique<Analyzer>(trie_, doc->sym, doc->log);
+        doc->an->setThreads(1);
+        if (!passes_.empty()) doc->an->configurePasses(passes_);
+        doc->session = std::make_unique<IncrementalSession>(*doc->an);
+        Document &d = *doc;
+        docs_[uri] = std::move(doc);
+        analyze(uri, d, out);
+    } else if (method == "textDocument/didChange"){
+        const std::string &uri = params["textDocument"]["uri"].asString();
+        auto it = docs_.find(uri);
+        if (it == docs_.end()) return;
+        Document &doc = *it->second;
+        doc.version = params["textDocument"]["version"].asInt(doc.version + 1);
+        for (const auto &change : params["contentChanges"].elements()){
+            const JsonValue &r = change["range"];
+            if (r.isObject()){
+                applyEdit(doc.lines, (size_t)r["start"]["line"].asInt(), (size_t)r["start"]["character"].asInt(),
+                          (size_t)r["end"]["line"].asInt(), (size_t)r["end"]["character"].asInt(), change["text"].asString());
+            } else {
+                splitText(change["text"].asString(), doc.lines);
+            }
+        }
+        analyze(uri, doc, out);
+    } else if (method == "textDocument/didClose"){
+        const std::string &uri = params["textDocument"]["uri"].asString();
+        if (!docs_.erase(uri)) return;
+        out.push_back(JsonValue::object().set("jsonrpc", "2.0").set("method", "textDocument/publishDiagnostics")
+                          .set("params", JsonValue::object().set("uri", uri).set("diagnostics", JsonValue::array())).dump());
+    } else if (method == "textDocument/codeAction"){
+        auto it = docs_.find(params["textDocument"]["uri"].asString());
+        if (it == docs_.end()){
+            out.push_back(error(id, kInvalidParams, "document is not open"));
+            return;
+        }
+        const JsonValue &r = params["range"];
+        size_t first = (size_t)std::max(0LL, r["start"]["line"].asInt()), last = (size_t)std::max(0LL, r["end"]["line"].asInt());
+        out.push_back(reply(id, codeActions(it->first, *it->second, first, last)));
+    } else if (isRequest){
+        out.push_back(error(id, kMethodNotFound, "unsupported method: " + method));
+    }
+    // Other notifications ($/cancelRequest, initialized, ...) need no answer
+}
+
+int LspServer::run(int inFd, int outFd){
+    FdReader in(inFd);
+    FdWriter outw(outFd);
+    in.tie(&outw); // replies go out before waiting for the next message
+    std::string line, body;
+    std::vector<std::string> replies;
+    while (!exit_){
+        size_t length = 0;
+        bool sawHeader = false, haveLength = false;
+        while (true){
+            if (!in.readLine(line)) return outw.flush(), exitCode();
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.empty()){
+                if (sawHeader) break;
+                continue;
+            }
+            sawHeader = true;
+            const std::string key = "content-length:";
+            if (line.size() > key.size() && std::equal(key.begin(), key.end(), line.begin(),
+                                                        [](char a, char b){ return a == std::tolower((unsigned char)b); })){
+                length = std::strtoull(line.c_str() + key.size(), nullptr, 10);
+                haveLength = true;
+            }
+        }
+        if (!haveLength) continue;
+        if (!in.read(length, body)) break;
+        replies.clear();
+        handle(body, replies);
+        for (auto &r : replies){
+            outw.write("Content-Length: " + std::to_string(r.size()) + "\r\n\r\n");
+            outw.write(r);
+        }
+    }
+    outw.flush();
+    return exitCode();
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "IncrementalSession.h"
+#include "Json.h"
+#include "Logger.h"
+#include "SymbolTable.h"
+#include "Trie.h"
+#include "Utils.h"
+
+// Language Server Protocol front end over stdio (JSON-RPC with Content-Length
+// headers). Supports initialize/shutdown/exit, didOpen/didChange/didClose with
+// incremental sync, and codeAction. After every change the document's
+// IncrementalSession re-fixes only the lines the edit can reach, reusing the
+// per-line results and brace/scope checkpoints of the previous run, and the
+// full diagnostic set is published: one diagnostic per issue, ranged from the
+// issue's column to the end of its line. Code actions offer each changed
+// line's correction and one "fix all" edit. Positions are UTF-16 columns.
+class LspServer {
+public:
+    LspServer();
+
+    // Pass configuration for every document, as for Analyzer::configurePasses
+    bool setPasses(const std::string &spec, std::string *error = nullptr);
+
+    // Handle one JSON-RPC message; the replies and notifications it causes are
+    // appended to out, as JSON texts in the order they must be sent
+    void handle(const std::string &message, std::vector<std::string> &out);
+
+    // Read framed messages from inFd and answer on outFd until "exit" or end
+    // of input. Returns the process exit code (0 only after a shutdown request).
+    int run(int inFd, int outFd);
+
+    bool exitRequested() const { return exit_; }
+    int exitCode() const { return shutdown_ ? 0 : 1; }
+
+    // Current text of an open document (nullptr if not open), for tests
+    const std::vector<std::string> *documentLines(const std::string &uri) const;
+    // Lines re-run by the last analysis
+    size_t lastRerun() const { return lastRerun_; }
+
+    // Character-level edit helpers, public for tests: replace the UTF-16 range
+    // [(startLine, startChar), (endLine, endChar)) of lines with text
+    static void applyEdit(std::vector<std::string> &lines, size_t startLine, size_t startChar,
+                          size_t endLine, size_t endChar, const std::string &text);
+    static void splitText(const std::string &text, std::vector<std::string> &lines);
+
+private:
+    struct Document {
+        long long version = 0;
+        std::vector<std::string> lines;
+        std::vector<std::string> fixed;      // session output, including appended lines
+        std::vector<std::string> fileIssues; // end-of-file issues
+        SymbolTable sym;
+        Logger log;
+        std::unique_ptr<Analyzer> an;
+        std::unique_ptr<IncrementalSession> session;
+    };
+
+    Trie trie_;
+    std::string passes_;
+    std::map<std::string, std::unique_ptr<Document>> docs_;
+    bool initialized_ = false, shutdown_ = false, exit_ = false;
+    size_t lastRerun_ = 0;
+
+    void analyze(const std::string &uri, Document &doc, std::vector<std::string> &out);
+    std::string diagnostics(const std::string &uri, const Document &doc) const;
+    JsonValue codeActions(const std::string &uri, const Document &doc, size_t firstLine, size_t lastLine) const;
+    static std::string reply(const JsonValue &id, JsonValue result);
+    static std::string error(const JsonValue &id, int code, const std::string &message);
+};
@@ -0,0 +1,77 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// Bounded lock-free queue for many producers and one consumer. Each slot
+// carries a sequence number telling whose turn it is: a producer claims the
+// tail with a compare-and-swap, fills the slot and publishes it by bumping the
+// sequence; the consumer takes slots strictly in claim order. No locks and no
+// allocation after construction; tryPush fails instead of waiting when full.
+// Items from one producer come out in the order that producer pushed them.
+template <typename T>
+class MpscRing {
+public:
+    // Capacity is rounded up to a power of two (at least 2)
+    explicit MpscRing(size_t capacity){
+        size_t n = 2;
+        while (n < capacity) n <<= 1;
+        mask_ = n - 1;
+        slots_.reset(new Slot[n]);
+        for (size_t i=0; i<n; ++i) slots_[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    MpscRing(const MpscRing &) = delete;
+    MpscRing &operator=(const MpscRing &) = delete;
+
+    size_t capacity() const { return mask_ + 1; }
+
+    // Any thread. False (item untouched) when the ring is full.
+    bool tryPush(T &item){
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        while (true){
+            Slot &slot = slots_[pos & mask_];
+            size_t seq = slot.seq.load(std::memory_order_acquire);
+            if (seq == pos){
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+                    slot.value = std::move(item);
+                    slot.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (seq < pos){
+                return false; // the consumer has not freed this slot yet
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer thread only. False when the next item is not published yet.
+    bool tryPop(T &out){
+        Slot &slot = slots_[head_ & mask_];
+        if (slot.seq.load(std::memory_order_acquire) != head_ + 1) return false;
+        out = std::move(slot.value);
+        slot.seq.store(head_ + mask_ + 1, std::memory_order_release);
+        headSeen_.store(++head_, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Approximate fill level (any thread), for wake-up heuristics
+    size_t sizeApprox() const {
+        size_t tail = tail_.load(std::memory_order_relaxed), head = headSeen_.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> seq{0};
+        T value;
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_ = 0;
+    alignas(64) std::atomic<size_t> tail_{0};
+    alignas(64) size_t head_ = 0;           // consumer-owned
+    std::atomic<size_t> headSeen_{0};       // copy of head_ other threads may read
+};
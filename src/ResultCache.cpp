@@ -0,0 +1,152 @@
+#include "ResultCache.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+static const char kMagic[] = "IFXC2";
+// Temporary files older than this belong to a writer that never finished
+static const auto kStaleTmpAge = std::chrono::minutes(10);
+
+ResultCache::ResultCache(std::string dir, uint64_t maxBytes, size_t maxEntries)
+    : dir_(std::move(dir)), maxBytes_(maxBytes), maxEntries_(maxEntries) {
+    std::error_code ec;
+    fs::create_directories(dir_, ec);
+}
+
+uint64_t ResultCache::hash(std::string_view data, uint64_t seed){
+    uint64_t h = seed;
+    for (unsigned char c : data){ h ^= c; h *= 1099511628211ull; }
+    return h;
+}
+
+uint64_t ResultCache::checksum(std::string_view data, uint64_t seed){
+    const uint64_t m = 0xC6A4A7935BD1E995ull;
+    const int r = 47;
+    uint64_t h = seed ^ (data.size() * m);
+    size_t i = 0;
+    for (; i + 8 <= data.size(); i += 8){
+        uint64_t k;
+        std::memcpy(&k, data.data() + i, 8);
+        k *= m; k ^= k >> r; k *= m;
+        h ^= k; h *= m;
+    }
+    if (i < data.size()){
+        uint64_t k = 0;
+        for (size_t j=data.size(); j>i; --j) k = (k << 8) | (unsigned char)data[j - 1];
+        h ^= k; h *= m;
+    }
+    h ^= h >> r; h *= m; h ^= h >> r;
+    return h;
+}
+
+std::string ResultCache::pathOf(uint64_t key) const {
+    char name[24];
+    snprintf(name, sizeof name, "%016llx.res", (unsigned long long)key);
+    return (fs::path(dir_) / name).string();
+}
+
+bool ResultCache::lookup(uint64_t key, const Source &src, Entry &entry){
+    std::string path = pathOf(key);
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()){ ++misses_; return false; }
+    // A damaged entry (crash, full disk, foreign file) is a miss and is dropped
+    auto corrupt = [&]{
+        in.close();
+        std::error_code ec;
+        fs::remove(path, ec);
+        ++misses_;
+        return false;
+    };
+    std::string head;
+    Source stored;
+    size_t nFixed = 0, nIssues = 0;
+    if (!std::getline(in, head) || head != kMagic
+        || !(in >> stored.bytes >> stored.check >> nFixed >> nIssues >> entry.issueCount >> entry.changedLines)
+        || in.get() != '\n') return corrupt();
+    // Same key, different input: a hash collision, not damage (the next store replaces it)
+    if (stored.bytes != src.bytes || stored.check != src.check){ ++misses_; return false; }
+    // Every line takes at least its newline: counts beyond the bytes left are damage,
+    // not something to allocate for
+    std::error_code ec;
+    uint64_t size = fs::file_size(path, ec);
+    std::streamoff at = in.tellg();
+    if (ec || at < 0 || (uint64_t)at > size) return corrupt();
+    uint64_t left = size - (uint64_t)at;
+    if (nFixed > left || nIssues > left - nFixed) return corrupt();
+    entry.fixed.resize(nFixed);
+    entry.issues.resize(nIssues);
+    for (auto &l : entry.fixed) if (!std::getline(in, l)) return corrupt();
+    for (auto &l : entry.issues) if (!std::getline(in, l)) return corrupt();
+
+    // Recently used: evict() goes by modification time
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+    ++hits_;
+    return true;
+}
+
+bool ResultCache::store(uint64_t key, const Source &src, const Entry &entry){
+    static std::atomic<uint64_t> serial{0};
+    std::string path = pathOf(key);
+    std::string tmp = path + "." + std::to_string(serial++) + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary);
+        if (!out.is_open()) return false;
+        out << kMagic << "\n" << src.bytes << " " << src.check << " " << entry.fixed.size() << " " << entry.issues.size() << " "
+            << entry.issueCount << " " << entry.changedLines << "\n";
+        for (const auto &l : entry.fixed) out << l << "\n";
+        for (const auto &l : entry.issues) out << l << "\n";
+        if (!out.flush()){ out.close(); std::error_code ec; fs::remove(tmp, ec); return false; }
+    }
+    // Readers see either the old entry or the complete new one
+    std::error_code ec;
+    fs::rename(tmp, path, ec);
+    if (ec){ fs::remove(tmp, ec); return false; }
+    ++stores_;
+    return true;
+}
+
+size_t ResultCache::evict(){
+    struct File { fs::file_time_type mtime; uint64_t size; fs::path path; };
+    std::vector<File> files;
+    uint64_t total = 0;
+    size_t stale = 0;
+    std::error_code ec;
+    const auto staleBefore = fs::file_time_type::clock::now() - kStaleTmpAge;
+    for (fs::directory_iterator it(dir_, ec), end; !ec && it != end; it.increment(ec)){
+        if (it->path().extension() == ".tmp"){
+            // Left by a writer that died before its rename; a recent one may still be in progress
+            std::error_code fec;
+            auto mtime = it->last_write_time(fec);
+            if (!fec && mtime < staleBefore && fs::remove(it->path(), fec)) ++stale;
+            continue;
+        }
+        if (it->path().extension() != ".res") continue;
+        std::error_code fec;
+        File f{it->last_write_time(fec), it->file_size(fec), it->path()};
+        if (fec) continue;
+        total += f.size;
+        files.push_back(std::move(f));
+    }
+    std::sort(files.begin(), files.end(), [](const File &a, const File &b){ return a.mtime < b.mtime; });
+
+    size_t removed = 0, count = files.size();
+    for (const auto &f : files){
+        if (total <= maxBytes_ && count <= maxEntries_) break;
+        if (fs::remove(f.path, ec)){ total -= f.size; --count; ++removed; }
+    }
+    evictions_ += removed;
+    entries_ = count;
+    bytes_ = total;
+    return removed + stale;
+}
+
+std::string ResultCache::stats() const {
+    return "result cache: " + std::to_string(hits_.load()) + " hits, " + std::to_string(misses_.load()) + " misses, "
+         + std::to_string(stores_.load()) + " stored, " + std::to_string(evictions_.load()) + " evicted, "
+         + std::to_string(entries_.load()) + " entries (" + std::to_string(bytes_.load()) + " bytes)";
+}
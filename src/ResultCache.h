@@ -0,0 +1,62 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Persistent, content-addressed store of batch results. An entry is keyed by a
+// hash of (file content, dictionary, rule configuration) and holds the corrected
+// lines and the issue list, so an unchanged file is answered without running the
+// Tokenizer or Analyzer. The entry also records the input's size and a second,
+// independent hash of the same parts, so a key collision reads as a miss instead
+// of another file's result. One file per entry under the cache directory; a hit
+// refreshes the entry's mtime, a damaged entry is a miss and is deleted, and
+// evict() drops the least recently used entries until the directory fits its
+// byte and entry limits. Safe to use from several threads at once (entries are
+// written to a temporary file and renamed).
+class ResultCache {
+public:
+    static const uint64_t kDefaultMaxBytes = 256ull << 20;
+    static const size_t kDefaultMaxEntries = 100000;
+
+    struct Entry {
+        std::vector<std::string> fixed;
+        std::vector<std::string> issues; // empty when only counted
+        size_t issueCount = 0;
+        size_t changedLines = 0;
+    };
+
+    // The input an entry was computed from, beyond its key
+    struct Source {
+        uint64_t bytes = 0;
+        uint64_t check = 0; // checksum() chained over the same parts as the key
+    };
+
+    explicit ResultCache(std::string dir, uint64_t maxBytes = kDefaultMaxBytes, size_t maxEntries = kDefaultMaxEntries);
+
+    // 64-bit FNV-1a; seed chains several parts into one key
+    static uint64_t hash(std::string_view data, uint64_t seed = 14695981039346656037ull);
+    // MurmurHash64A, unrelated to hash(); seed chains like hash()
+    static uint64_t checksum(std::string_view data, uint64_t seed = 0x9E3779B97F4A7C15ull);
+
+    // A stored entry whose source differs from src is a miss
+    bool lookup(uint64_t key, const Source &src, Entry &entry);
+    bool store(uint64_t key, const Source &src, const Entry &entry);
+    // Enforce the limits, oldest entries first, and delete temporary files left
+    // by interrupted stores; returns the number of files removed
+    size_t evict();
+
+    const std::string &dir() const { return dir_; }
+    // "result cache: H hits, M misses, S stored, E evicted, N entries (B bytes)"
+    std::string stats() const;
+
+private:
+    std::string dir_;
+    uint64_t maxBytes_;
+    size_t maxEntries_;
+    std::atomic<uint64_t> hits_{0}, misses_{0}, stores_{0}, evictions_{0};
+    std::atomic<uint64_t> entries_{0}, bytes_{0}; // as of the last evict()
+
+    std::string pathOf(uint64_t key) const;
+};
@@ -0,0 +1,186 @@
+#include "RuleEngine.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+
+using Clock = std::chrono::steady_clock;
+
+static uint64_t elapsedNanos(Clock::time_point since){
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - since).count();
+}
+
+void RuleEngine::add(Rule rule){
+    rules_.push_back(std::move(rule));
+    updateRewriters();
+}
+
+// A rule gated on a keyword the word rules would have produced (cot -> cout)
+// has to see every line while one of those rules is off
+void RuleEngine::updateRewriters(){
+    rewritersOff_ = false;
+    for (const auto &r : rules_) if (r.rewritesWords && !r.enabled) rewritersOff_ = true;
+}
+
+bool RuleEngine::setEnabled(const std::string &name, bool enabled){
+    for (auto &r : rules_){
+        if (r.name == name){ r.enabled = enabled; updateRewriters(); return true; }
+    }
+    return false;
+}
+
+bool RuleEngine::configure(const std::string &spec, std::string *error){
+    std::istringstream in(spec);
+    std::string item;
+    bool ok = true;
+    while (std::getline(in, item, ',')){
+        // trim
+        size_t b = item.find_first_not_of(" \t"), e = item.find_last_not_of(" \t");
+        if (b == std::string::npos) continue;
+        item = item.substr(b, e - b + 1);
+
+        std::string name = item;
+        bool on = true;
+        if (item[0] == '-' || item[0] == '+'){
+            on = item[0] == '+';
+            name = item.substr(1);
+        } else {
+            size_t eq = item.find('=');
+            if (eq != std::string::npos){
+                name = item.substr(0, eq);
+                std::string v = item.substr(eq + 1);
+                if (v == "off" || v == "0" || v == "false") on = false;
+                else if (v == "on" || v == "1" || v == "true") on = true;
+                else { if (error) *error += "bad value for " + name + ": " + v + "\n"; ok = false; continue; }
+            }
+        }
+        if (!setEnabled(name, on)){
+            if (error) *error += "unknown pass: " + name + "\n";
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+std::vector<std::string> RuleEngine::formatStats(const std::vector<RuleStats> &stats) const {
+    std::vector<std::string> out;
+    char buf[160];
+    snprintf(buf, sizeof buf, "%-26s %-4s %10s %12s %8s %10s", "pass", "on", "lines", "tokens", "fixes", "time(ms)");
+    out.push_back(buf);
+    RuleStats total;
+    for (size_t r=0; r<rules_.size(); ++r){
+        RuleStats st = r < stats.size() ? stats[r] : RuleStats();
+        total += st;
+        snprintf(buf, sizeof buf, "%-26s %-4s %10llu %12llu %8llu %10.3f", rules_[r].name.c_str(),
+                 rules_[r].enabled ? "yes" : "no", (unsigned long long)st.lines, (unsigned long long)st.tokens,
+                 (unsigned long long)st.fixes, st.nanos / 1e6);
+        out.push_back(buf);
+    }
+    snprintf(buf, sizeof buf, "%-26s %-4s %10s %12llu %8llu %10.3f", "total", "", "",
+             (unsigned long long)total.tokens, (unsigned long long)total.fixes, total.nanos / 1e6);
+    out.push_back(buf);
+    return out;
+}
+
+RuleEngine::Gate RuleEngine::lineGate(const Rule &rule, const RuleContext &ctx) const {
+    if (!rule.enabled) return OFF;
+    const LineSummary &sum = ctx.stream.summary;
+    const RulePattern &p = rule.pattern;
+    if (p.kinds && !(sum.kinds & p.kinds)) return OFF;
+    if (rule.when && !rule.when(ctx)) return OFF;
+    if (p.keywords && !(sum.keywords & p.keywords)){
+        if (!p.afterRewrite) return OFF;
+        return ctx.rewritten || rewritersOff_ ? ON : AFTER_REWRITE;
+    }
+    return ON;
+}
+
+void RuleEngine::run(RuleContext &ctx, IssueList &issues) const {
+    ctx.issues.resize(rules_.size());
+    for (auto &bucket : ctx.issues){ bucket.clear(); bucket.bind(&ctx.names); }
+    if (ctx.stats.size() < rules_.size()) ctx.stats.resize(rules_.size());
+    ctx.rewritten = false;
+    ctx.rewriter.reset(ctx.tokens);
+
+    size_t r = 0;
+    while (r < rules_.size()){
+        const Rule &rule = rules_[r];
+        if (rule.scope == Rule::Scope::TOKEN){
+            size_t end = r;
+            while (end < rules_.size() && rules_[end].scope == Rule::Scope::TOKEN) ++end;
+            runTokenGroup(ctx, r, end);
+            r = end;
+            continue;
+        }
+        if (lineGate(rule, ctx) == ON){
+            auto &bucket = ctx.issues[r];
+            RuleStats &st = ctx.stats[r];
+            size_t before = bucket.size();
+            st.lines++;
+            st.tokens += ctx.rewriter.size();
+            if (timing_){
+                auto t0 = Clock::now();
+                rule.onLine(ctx, bucket);
+                st.nanos += elapsedNanos(t0);
+            } else {
+                rule.onLine(ctx, bucket);
+            }
+            st.fixes += bucket.size() - before;
+            if (rule.rewritesWords && bucket.size() != before) ctx.rewritten = true;
+        }
+        ++r;
+    }
+
+    ctx.rewriter.commit(ctx.tokens);
+
+    for (auto &bucket : ctx.issues){
+        for (auto &issue : bucket) issues.push_back(issue);
+    }
+}
+
+void RuleEngine::runTokenGroup(RuleContext &ctx, size_t begin, size_t end) const {
+    const size_t count = end - begin;
+    ctx.gate.resize(count);
+    ctx.skipUntil.assign(count, 0);
+    bool any = false;
+    for (size_t k=0; k<count; ++k){
+        ctx.gate[k] = lineGate(rules_[begin + k], ctx);
+        if (ctx.gate[k] == ON) ctx.stats[begin + k].lines++;
+        any = any || ctx.gate[k] != OFF;
+    }
+    if (!any) return;
+
+    auto &tokens = ctx.rewriter;
+    for (size_t i=0; i<tokens.size(); ++i){
+        for (size_t k=0; k<count; ++k){
+            if (ctx.gate[k] == OFF) continue;
+            if (ctx.gate[k] == AFTER_REWRITE){
+                if (!ctx.rewritten) continue;
+                ctx.gate[k] = ON;
+                ctx.stats[begin + k].lines++;
+            }
+            if (i < ctx.skipUntil[k]) continue;
+            const Rule &rule = rules_[begin + k];
+            // Kind is re-read per rule: an earlier rule may have retyped the token
+            if (rule.pattern.kinds && !(rule.pattern.kinds & LineSummary::kindBit(tokens[i].type))) continue;
+
+            auto &bucket = ctx.issues[begin + k];
+            RuleStats &st = ctx.stats[begin + k];
+            size_t before = bucket.size();
+            size_t inserted;
+            st.tokens++;
+            if (timing_){
+                auto t0 = Clock::now();
+                inserted = rule.onToken(ctx, i, bucket);
+                st.nanos += elapsedNanos(t0);
+            } else {
+                inserted = rule.onToken(ctx, i, bucket);
+            }
+            st.fixes += bucket.size() - before;
+            if (rule.rewritesWords && bucket.size() != before) ctx.rewritten = true;
+            if (inserted){
+                for (size_t q=0; q<=k; ++q) ctx.skipUntil[q] = std::max(ctx.skipUntil[q], i + 1 + inserted);
+            }
+        }
+    }
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "Tokenizer.h"
+#include "TokenStream.h"
+#include "Issue.h"
+#include "TokenRewriter.h"
+#include "CorrectionMemo.h"
+
+// What a rule reacts to. A rule runs on a line only if the line summary matches;
+// TOKEN rules are then called only for tokens of the listed kinds.
+struct RulePattern {
+    uint32_t kinds = 0;        // LineSummary::kindBit mask, 0 = any kind
+    uint64_t keywords = 0;     // keyword id mask, 0 = no keyword required
+    bool afterRewrite = false; // keyword requirement is waived once a word on the line was rewritten,
+                               // and always while a rewritesWords rule is disabled
+};
+
+struct RuleContext;
+
+// Per-pass counters: lines the pass ran on, tokens it examined, fixes (issues) it
+// reported and wall time spent in it
+struct RuleStats {
+    uint64_t lines = 0;
+    uint64_t tokens = 0;
+    uint64_t fixes = 0;
+    uint64_t nanos = 0;
+
+    RuleStats &operator+=(const RuleStats &o){
+        lines += o.lines; tokens += o.tokens; fixes += o.fixes; nanos += o.nanos;
+        return *this;
+    }
+};
+
+struct Rule {
+    enum class Scope { LINE, TOKEN };
+
+    std::string name;
+    Scope scope = Scope::LINE;
+    bool enabled = true;
+    RulePattern pattern;
+    bool rewritesWords = false; // issues reported by this rule mean token words changed
+
+    // Optional extra line gate, checked after the pattern
+    std::function<bool(const RuleContext &)> when;
+
+    // LINE rules: called once per line (the tokens are ctx.rewriter)
+    std::function<void(RuleContext &, IssueList &)> onLine;
+
+    // TOKEN rules: called for token i; returns how many tokens it inserted right
+    // after i (this rule and the rules before it will not visit those)
+    std::function<size_t(RuleContext &, size_t, IssueList &)> onToken;
+};
+
+// Working state for one engine run; reuse one per thread so buffers stop growing
+struct RuleContext {
+    TokenStream stream;          // the tokenized line (summary is taken before any rewrite)
+    std::vector<Token> tokens;   // the line's tokens before and after a run
+    TokenRewriter rewriter;      // holds `tokens` while the rules edit them
+    bool rewritten = false;      // a rewritesWords rule changed a word on this line
+
+    Interner names;                               // words quoted by this context's issues
+    std::vector<IssueList> issues;                // per rule, merged in rule order
+    std::vector<RuleStats> stats;                 // per rule, accumulated across runs
+    std::vector<size_t> skipUntil;                // per rule of the current token group
+    std::vector<uint8_t> gate;                    // per rule of the current token group
+
+    CorrectionMemo memo;                          // dictionary decisions, kept across lines
+};
+
+// Runs rules in registration order. Consecutive TOKEN rules are fused into a
+// single walk: at each token every rule of the group runs in order. This is
+// equivalent to separate passes for rules that only edit the current token or
+// tokens ahead of it (and never depend on an earlier rule having visited those
+// first). Tokens a rule inserts are seen only by the rules after it, just as if
+// the passes had run one after another. Issues are collected per rule and merged
+// in rule order, so the issue list matches the sequential pipeline too.
+class RuleEngine {
+public:
+    void add(Rule rule);
+    const std::vector<Rule> &rules() const { return rules_; }
+
+    // Enable/disable a rule by name; false if no rule has that name
+    bool setEnabled(const std::string &name, bool enabled);
+
+    // Apply a configuration like "fixForLoop=off,fixIdentifiers=on" (also accepts
+    // "-name"/"+name"). Unknown names are reported in `error` and return false.
+    bool configure(const std::string &spec, std::string *error = nullptr);
+
+    // Per-rule wall-time measurement, off by default: it costs two clock reads
+    // per token per rule (counters are always kept)
+    void setTiming(bool on) { timing_ = on; }
+
+    // Run every rule over ctx.tokens, appending issues to `issues` (whose word
+    // ids must refer to ctx.names)
+    void run(RuleContext &ctx, IssueList &issues) const;
+
+    // Pass table for stats (one row per rule, in pipeline order)
+    std::vector<std::string> formatStats(const std::vector<RuleStats> &stats) const;
+
+private:
+    std::vector<Rule> rules_;
+    bool timing_ = false;
+    bool rewritersOff_ = false; // some rewritesWords rule is disabled
+
+    enum Gate : uint8_t { OFF, ON, AFTER_REWRITE };
+    Gate lineGate(const Rule &rule, const RuleContext &ctx) const;
+    void runTokenGroup(RuleContext &ctx, size_t begin, size_t end) const;
+    void updateRewriters();
+};
@@ -1,25 +1,105 @@
 #include "SymbolTable.h"
 
 SymbolTable::SymbolTable(){
+    slots_.assign(64, 0);
     enterScope();
 }
 
 void SymbolTable::enterScope(){
-    scopes_.push_back({});
+    scopeMarks_.push_back((uint32_t)undo_.size());
 }
 
 void SymbolTable::exitScope(){
-    if (!scopes_.empty()) scopes_.pop_back();
+    if (scopeMarks_.size() <= 1) return;
+    // Unwind this scope's declarations, re-exposing whatever they shadowed
+    uint32_t mark = scopeMarks_.back();
+    while (undo_.size() > mark){
+        toggle(undo_.back().name, scopeMarks_.size());
+        top_[undo_.back().name] = undo_.back().prev;
+        undo_.pop_back();
+    }
+    scopeMarks_.pop_back();
+}
+
+void SymbolTable::clear(){
+    if (names_.size() >= kMaxNames){
+        names_.clear();
+        hashes_.clear();
+        top_.clear();
+        slots_.assign(64, 0);
+    } else {
+        for (const auto &s : undo_) top_[s.name] = kNone;
+    }
+    undo_.clear();
+    scopeMarks_.clear();
+    fingerprint_ = 0;
+    enterScope();
+}
+
+void SymbolTable::declare(std::string_view name){
+    uint32_t id = internId(name, hashOf(name));
+    // Already declared in this scope: nothing to shadow
+    if (top_[id] != kNone && top_[id] >= scopeMarks_.back()) return;
+    undo_.push_back({id, top_[id]});
+    top_[id] = (uint32_t)undo_.size() - 1;
+    toggle(id, scopeMarks_.size());
+}
+
+bool SymbolTable::isDeclared(std::string_view name) const{
+    uint32_t id = findId(name, hashOf(name));
+    return id != kNone && top_[id] != kNone;
+}
+
+uint64_t SymbolTable::fingerprint() const{
+    return fingerprint_ ^ mix(scopeMarks_.size());
+}
+
+// splitmix64 finalizer
+uint64_t SymbolTable::mix(uint64_t x){
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// 64-bit FNV-1a
+uint64_t SymbolTable::hashOf(std::string_view s){
+    uint64_t h = 14695981039346656037ull;
+    for (unsigned char c : s){ h ^= c; h *= 1099511628211ull; }
+    return h;
+}
+
+uint32_t SymbolTable::findId(std::string_view name, uint64_t hash) const{
+    size_t mask = slots_.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask){
+        uint32_t slot = slots_[i];
+        if (!slot) return kNone;
+        if (hashes_[slot - 1] == hash && names_[slot - 1] == name) return slot - 1;
+    }
 }
 
-void SymbolTable::declare(const std::string &name){
-    if (scopes_.empty()) enterScope();
-    scopes_.back().insert(name);
+uint32_t SymbolTable::internId(std::string_view name, uint64_t hash){
+    uint32_t id = findId(name, hash);
+    if (id != kNone) return id;
+    // Keep the load factor at or below 1/2
+    if ((names_.size() + 1) * 2 > slots_.size()) grow();
+    id = (uint32_t)names_.size();
+    names_.emplace_back(name);
+    hashes_.push_back(hash);
+    top_.push_back(kNone);
+    size_t mask = slots_.size() - 1;
+    size_t i = hash & mask;
+    while (slots_[i]) i = (i + 1) & mask;
+    slots_[i] = id + 1;
+    return id;
 }
 
-bool SymbolTable::isDeclared(const std::string &name) const{
-    for (auto it = scopes_.rbegin(); it != scopes_.rend(); ++it){
-        if (it->count(name)) return true;
+void SymbolTable::grow(){
+    slots_.assign(slots_.size() * 2, 0);
+    size_t mask = slots_.size() - 1;
+    for (uint32_t id=0; id<names_.size(); ++id){
+        size_t i = hashes_[id] & mask;
+        while (slots_[i]) i = (i + 1) & mask;
+        slots_[i] = id + 1;
     }
-    return false;
 }
@@ -1,18 +1,59 @@
 #pragma once
+#include <cstdint>
 #include <string>
-#include <unordered_set>
+#include <string_view>
 #include <vector>
 
+// Scoped set of declared names, stored flat: an open-addressing table maps each
+// name to a small id, and each id has a shadow stack of its live declarations.
+// The shadow stacks are threaded through one shared undo log, so lookups cost
+// one hash probe at any nesting depth and exitScope only touches the names that
+// scope declared.
 class SymbolTable {
 public:
+    // clear() also forgets the interned names once there are this many
+    static const size_t kMaxNames = 1 << 16;
+
     SymbolTable();
 
     void enterScope();
-    void exitScope();
+    void exitScope(); // the outermost scope is never popped
+
+    // Drop every declaration (back to a single empty scope)
+    void clear();
+
+    void declare(std::string_view name);
+    bool isDeclared(std::string_view name) const;
 
-    void declare(const std::string &name);
-    bool isDeclared(const std::string &name) const;
+    size_t depth() const { return scopeMarks_.size(); }
+    // Hash of the visible state (live names and the depth of each, plus the
+    // current depth); equal tables give equal fingerprints. Kept up to date
+    // incrementally, so this is O(1).
+    uint64_t fingerprint() const;
 
 private:
-    std::vector<std::unordered_set<std::string>> scopes_;
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    // One live declaration; prev links to the shadowed one of the same name
+    struct Shadow {
+        uint32_t name;
+        uint32_t prev;
+    };
+
+    static uint64_t hashOf(std::string_view s);
+    static uint64_t mix(uint64_t x);
+    // Keyed on the full name hash, not the id: ids are reassigned when an older
+    // snapshot is restored, so one id can stand for different names across runs
+    void toggle(uint32_t id, size_t depth) { fingerprint_ ^= mix(hashes_[id] + mix(depth)); }
+    uint32_t findId(std::string_view name, uint64_t hash) const;
+    uint32_t internId(std::string_view name, uint64_t hash);
+    void grow();
+
+    std::vector<std::string> names_;   // id -> name
+    std::vector<uint64_t> hashes_;     // id -> hash of the name
+    std::vector<uint32_t> top_;        // id -> innermost live Shadow, or kNone
+    std::vector<uint32_t> slots_;      // open addressing: id + 1, 0 = empty
+    std::vector<Shadow> undo_;         // declarations, innermost scope last
+    std::vector<uint32_t> scopeMarks_; // undo_ size when each scope was entered
+    uint64_t fingerprint_ = 0;         // XOR of toggle() over live declarations
 };
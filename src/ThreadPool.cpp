@@ -0,0 +1,82 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+WorkStealingPool::WorkStealingPool(unsigned threads){
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned i=0; i<threads; ++i) queues_.push_back(std::make_unique<Queue>());
+    for (unsigned i=0; i<threads; ++i) threads_.emplace_back(&WorkStealingPool::workerLoop, this, i);
+}
+
+WorkStealingPool::~WorkStealingPool(){
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto &t : threads_) t.join();
+}
+
+void WorkStealingPool::submit(Task task){
+    unsigned w;
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        ++pending_;
+        w = next_++ % size();
+    }
+    {
+        // Counted under the queue lock: the pop that takes this task (which
+        // decrements under the same lock) cannot run before the increment
+        std::lock_guard<std::mutex> lk(queues_[w]->m);
+        queues_[w]->tasks.push_back(std::move(task));
+        ++queued_;
+    }
+    // A worker testing queued_ under m_ has either seen the task or is already waiting
+    { std::lock_guard<std::mutex> lk(m_); }
+    wake_.notify_one();
+}
+
+void WorkStealingPool::wait(){
+    std::unique_lock<std::mutex> lk(m_);
+    idle_.wait(lk, [this]{ return pending_ == 0; });
+}
+
+bool WorkStealingPool::tryPop(unsigned worker, Task &task){
+    // Own deque: newest first (LIFO keeps caches warm)
+    {
+        Queue &q = *queues_[worker];
+        std::lock_guard<std::mutex> lk(q.m);
+        if (!q.tasks.empty()){
+            task = std::move(q.tasks.back());
+            q.tasks.pop_back();
+            --queued_;
+            return true;
+        }
+    }
+    // Steal: oldest task of the next non-empty deque
+    for (unsigned k=1; k<size(); ++k){
+        Queue &q = *queues_[(worker + k) % size()];
+        std::lock_guard<std::mutex> lk(q.m);
+        if (!q.tasks.empty()){
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+            --queued_;
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(unsigned worker){
+    while (true){
+        Task task;
+        if (tryPop(worker, task)){
+            task(worker);
+            std::lock_guard<std::mutex> lk(m_);
+            if (--pending_ == 0) idle_.notify_all();
+            continue;
+        }
+        std::unique_lock<std::mutex> lk(m_);
+        wake_.wait(lk, [this]{ return stop_ || queued_.load() > 0; });
+        if (stop_ && queued_.load() == 0) return;
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size work-stealing thread pool. Every worker owns a deque: it takes work
+// from the back of its own deque and, when that is empty, steals from the front
+// of the others. Tasks receive the index of the worker running them, so callers
+// can keep per-worker state (e.g. one Analyzer per worker) without locking.
+class WorkStealingPool {
+public:
+    using Task = std::function<void(unsigned worker)>;
+
+    explicit WorkStealingPool(unsigned threads = 0); // 0 = one per hardware thread
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    unsigned size() const { return (unsigned)queues_.size(); }
+
+    // Queue a task (round-robin over the worker deques)
+    void submit(Task task);
+
+    // Block until every submitted task has finished
+    void wait();
+
+private:
+    struct Queue {
+        std::mutex m;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> threads_;
+
+    std::mutex m_;
+    std::condition_variable wake_;  // work queued or stopping
+    std::condition_variable idle_;  // pending_ dropped to zero
+    std::atomic<size_t> queued_{0}; // tasks sitting in deques
+    size_t pending_ = 0;            // tasks submitted but not finished
+    unsigned next_ = 0;
+    bool stop_ = false;
+
+    bool tryPop(unsigned worker, Task &task);
+    void workerLoop(unsigned worker);
+};
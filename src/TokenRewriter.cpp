@@ -0,0 +1,57 @@
+#include "TokenRewriter.h"
+#include <algorithm>
+
+void TokenRewriter::reset(std::vector<Token> &tokens){
+    buf_.swap(tokens);
+    gapBegin_ = buf_.size();
+    gap_ = 0;
+}
+
+void TokenRewriter::commit(std::vector<Token> &tokens){
+    flat();
+    tokens.swap(buf_);
+    buf_.clear();
+    gapBegin_ = gap_ = 0;
+}
+
+std::vector<Token> &TokenRewriter::flat(){
+    moveGap(size());
+    buf_.resize(gapBegin_);
+    gap_ = 0;
+    return buf_;
+}
+
+void TokenRewriter::moveGap(size_t pos){
+    if (gap_ == 0){ gapBegin_ = pos; return; }
+    if (pos < gapBegin_){
+        for (size_t k=gapBegin_; k-- > pos; ) buf_[k + gap_] = std::move(buf_[k]);
+    } else {
+        for (size_t k=gapBegin_; k<pos; ++k) buf_[k] = std::move(buf_[k + gap_]);
+    }
+    gapBegin_ = pos;
+}
+
+void TokenRewriter::grow(){
+    // Double the free space and shift the tail behind the new gap
+    const size_t n = buf_.size();
+    const size_t extra = std::max<size_t>(8, size());
+    buf_.resize(n + extra);
+    for (size_t k=n; k-- > gapBegin_ + gap_; ) buf_[k + extra] = std::move(buf_[k]);
+    gap_ += extra;
+}
+
+void TokenRewriter::insert(size_t pos, Token tok){
+    // An inserted token is placed in the source where its successor starts (or
+    // right after its predecessor at the end of the line)
+    if (pos < size()) tok.pos = (*this)[pos].pos;
+    else if (pos > 0){ const Token &prev = (*this)[pos - 1]; tok.pos = prev.pos + (uint32_t)prev.value.size(); }
+    moveGap(pos);
+    if (gap_ == 0) grow();
+    buf_[gapBegin_++] = std::move(tok);
+    --gap_;
+}
+
+void TokenRewriter::erase(size_t pos){
+    moveGap(pos);
+    ++gap_;
+}
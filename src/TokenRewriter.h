@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "Tokenizer.h"
+
+// Editable token sequence for the fix passes. Tokens live in a gap buffer: edits
+// (insert/erase) land in a gap kept at the edit point, and commit() closes the gap
+// in one pass. Passes edit left to right, so a whole line of edits costs O(tokens)
+// instead of one vector shift per insert. Edits are visible immediately: a pass
+// (or a later pass in a fused walk) sees inserted tokens at their new positions.
+class TokenRewriter {
+public:
+    // Take over `tokens` for editing (no copy); hand them back with commit()
+    void reset(std::vector<Token> &tokens);
+    void commit(std::vector<Token> &tokens);
+
+    size_t size() const { return buf_.size() - gap_; }
+    bool empty() const { return size() == 0; }
+    Token &operator[](size_t i) { return buf_[i < gapBegin_ ? i : i + gap_]; }
+    const Token &operator[](size_t i) const { return buf_[i < gapBegin_ ? i : i + gap_]; }
+
+    void insert(size_t pos, Token tok);
+    void push_back(Token tok) { insert(size(), std::move(tok)); }
+    void erase(size_t pos);
+
+    // Contiguous view of the current tokens (closes the gap); stays editable
+    std::vector<Token> &flat();
+
+private:
+    std::vector<Token> buf_;
+    size_t gapBegin_ = 0; // logical position of the gap
+    size_t gap_ = 0;      // free slots at buf_[gapBegin_, gapBegin_ + gap_)
+
+    void moveGap(size_t pos);
+    void grow();
+};
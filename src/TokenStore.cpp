@@ -0,0 +1,70 @@
+#include "TokenStore.h"
+#include <algorithm>
+
+TokenStore::TokenStore(const Tokenizer &tokenizer) : tokenizer_(tokenizer) {}
+
+std::unique_ptr<TokenStore::Line> TokenStore::makeLine(const std::string &text) const {
+    auto ln = std::make_unique<Line>();
+    ln->text = text;
+    tokenizer_.tokenize(ln->text, ln->stream);
+    ln->version = version_;
+    return ln;
+}
+
+void TokenStore::assign(const std::vector<std::string> &lines){
+    ++version_;
+    lines_.clear();
+    lines_.reserve(lines.size());
+    for (const auto &l : lines) lines_.push_back(makeLine(l));
+}
+
+LineRange TokenStore::replaceLines(size_t first, size_t count, const std::vector<std::string> &newLines){
+    first = std::min(first, lines_.size());
+    count = std::min(count, lines_.size() - first);
+    ++version_;
+
+    // Re-lex the replacement lines only, then splice them over the old ones
+    size_t common = std::min(count, newLines.size());
+    for (size_t k=0; k<common; ++k) lines_[first + k] = makeLine(newLines[k]);
+    if (newLines.size() > count){
+        std::vector<std::unique_ptr<Line>> extra;
+        extra.reserve(newLines.size() - count);
+        for (size_t k=count; k<newLines.size(); ++k) extra.push_back(makeLine(newLines[k]));
+        lines_.insert(lines_.begin() + first + count,
+                      std::make_move_iterator(extra.begin()), std::make_move_iterator(extra.end()));
+    } else if (count > newLines.size()){
+        lines_.erase(lines_.begin() + first + common, lines_.begin() + first + count);
+    }
+    return {first, newLines.size()};
+}
+
+LineRange TokenStore::edit(size_t startLine, size_t startCol, size_t endLine, size_t endCol, const std::string &text){
+    if (lines_.empty()) lines_.push_back(makeLine(""));
+    startLine = std::min(startLine, lines_.size() - 1);
+    endLine = std::min(std::max(endLine, startLine), lines_.size() - 1);
+    const std::string &head = lines_[startLine]->text;
+    const std::string &tail = lines_[endLine]->text;
+    startCol = std::min(startCol, head.size());
+    endCol = std::min(endCol, tail.size());
+    if (endLine == startLine) endCol = std::max(endCol, startCol);
+
+    // Build the replacement lines: prefix of the first line + text + suffix of the last
+    std::string merged = head.substr(0, startCol) + text + tail.substr(endCol);
+    std::vector<std::string> newLines;
+    size_t pos = 0;
+    while (true){
+        size_t nl = merged.find('\n', pos);
+        if (nl == std::string::npos){ newLines.push_back(merged.substr(pos)); break; }
+        size_t end = (nl > pos && merged[nl-1] == '\r') ? nl - 1 : nl;
+        newLines.push_back(merged.substr(pos, end - pos));
+        pos = nl + 1;
+    }
+    return replaceLines(startLine, endLine - startLine + 1, newLines);
+}
+
+std::vector<std::string> TokenStore::lines() const {
+    std::vector<std::string> out;
+    out.reserve(lines_.size());
+    for (const auto &ln : lines_) out.push_back(ln->text);
+    return out;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Tokenizer.h"
+#include "TokenStream.h"
+
+// Lines [first, first+count) in the store's current numbering
+struct LineRange {
+    size_t first = 0;
+    size_t count = 0;
+};
+
+// Versioned per-line token store for editor integration. Edits splice new lines
+// into the existing file and re-lex only the lines they touch; every other line
+// keeps its TokenStream (and the version it was lexed at).
+//
+// The Tokenizer carries no state across lines (comments and literals end at the
+// line end), so the lexer state at every line boundary is the initial state and
+// re-lexing is back in sync as soon as the edited lines are done.
+class TokenStore {
+public:
+    explicit TokenStore(const Tokenizer &tokenizer);
+
+    // Replace the whole document
+    void assign(const std::vector<std::string> &lines);
+
+    // Replace `count` lines starting at `first` with `newLines`
+    LineRange replaceLines(size_t first, size_t count, const std::vector<std::string> &newLines);
+
+    // Replace the text between (startLine, startCol) and (endLine, endCol) with
+    // `text`, which may contain newlines. Columns are byte offsets and are clamped
+    // to the line length.
+    LineRange edit(size_t startLine, size_t startCol, size_t endLine, size_t endCol, const std::string &text);
+
+    size_t lineCount() const { return lines_.size(); }
+    const std::string &line(size_t i) const { return lines_[i]->text; }
+    const TokenStream &tokens(size_t i) const { return lines_[i]->stream; }
+
+    // Store version (bumped by every edit) and the version each line was last lexed at
+    uint64_t version() const { return version_; }
+    uint64_t lineVersion(size_t i) const { return lines_[i]->version; }
+
+    std::vector<std::string> lines() const;
+
+private:
+    struct Line {
+        std::string text;
+        TokenStream stream; // spans into text; Line is heap-allocated so they stay valid
+        uint64_t version = 0;
+    };
+
+    const Tokenizer &tokenizer_;
+    std::vector<std::unique_ptr<Line>> lines_;
+    uint64_t version_ = 0;
+
+    std::unique_ptr<Line> makeLine(const std::string &text) const;
+};
@@ -0,0 +1,32 @@
+#include "TokenStream.h"
+
+void TokenStream::clear(){
+    kinds.clear();
+    offsets.clear();
+    lengths.clear();
+    keywordIds.clear();
+    summary = LineSummary();
+    source = std::string_view();
+}
+
+size_t TokenStream::nextMeaningful(size_t from) const {
+    const uint8_t ws = static_cast<uint8_t>(TokType::WHITESPACE);
+    const size_t n = kinds.size();
+    while (from < n && kinds[from] == ws) ++from;
+    return from;
+}
+
+void TokenStream::toTokens(std::vector<Token> &out) const {
+    const size_t n = kinds.size();
+    if (out.size() > n) out.resize(n);
+    for (size_t i=0; i<n; ++i){
+        if (i < out.size()){
+            out[i].type = kind(i);
+            out[i].value.assign(source.data() + offsets[i], lengths[i]);
+            out[i].pos = offsets[i];
+            out[i].flags = 0;
+        } else {
+            out.push_back({kind(i), std::string(text(i)), offsets[i]});
+        }
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Tokenizer.h"
+
+// Which token kinds and keywords occur on a line (bit per TokType / keyword id)
+struct LineSummary {
+    uint32_t kinds = 0;
+    uint64_t keywords = 0;
+
+    static uint32_t kindBit(TokType t) { return 1u << static_cast<unsigned>(t); }
+    bool hasKind(TokType t) const { return (kinds & kindBit(t)) != 0; }
+    bool hasKeyword(int id) const { return id >= 0 && ((keywords >> id) & 1u) != 0; }
+};
+
+// Struct-of-arrays token stream for one line. Tokens are spans into `source`
+// (offset + length), so building a stream copies no strings, and scans over
+// token kinds walk a plain byte array.
+class TokenStream {
+public:
+    std::vector<uint8_t> kinds;      // TokType per token
+    std::vector<uint32_t> offsets;   // byte offset into source
+    std::vector<uint32_t> lengths;   // byte length
+    std::vector<int8_t> keywordIds;  // Tokenizer keyword id, -1 for non-keywords
+    LineSummary summary;
+    std::string_view source;
+
+    void clear();
+    size_t size() const { return kinds.size(); }
+
+    TokType kind(size_t i) const { return static_cast<TokType>(kinds[i]); }
+    std::string_view text(size_t i) const { return source.substr(offsets[i], lengths[i]); }
+
+    // Index of the first non-whitespace token at or after `from`; size() if none
+    size_t nextMeaningful(size_t from) const;
+
+    // Materialize as Token records (reusing the slots already in `out`)
+    void toTokens(std::vector<Token> &out) const;
+};
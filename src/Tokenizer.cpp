@@ -1,4 +1,6 @@
 #include "Tokenizer.h"
+#include "TokenStream.h"
+#include "Utf8.h"
 #include <cctype>
 #include <algorithm>
 #include <cstring>
@@ -11,7 +13,16 @@ void Tokenizer::initKeywords(){
         "int","float","double","char","void","auto","switch","case","break","continue","true","false",
         "template","typename","public","private","protected","std","cout","cin","cerr","main","string","vector","map","unordered_map","push_back","sort","pair","queue","stack"
     };
-    for (auto k : kws) keywords_.insert(k);
+    int id = 0;
+    for (auto k : kws){ keywords_.emplace(k, id++); maxKeywordLen_ = std::max(maxKeywordLen_, strlen(k)); }
+}
+
+int Tokenizer::keywordId(const std::string &word) const {
+    if (word.size() > maxKeywordLen_) return -1;
+    std::string lw = word;
+    std::transform(lw.begin(), lw.end(), lw.begin(), [](unsigned char ch){ return (char)std::tolower(ch); });
+    auto it = keywords_.find(lw);
+    return it == keywords_.end() ? -1 : it->second;
 }
 
 Tokenizer::Tokenizer(){ initKeywords(); }
@@ -19,61 +30,137 @@ Tokenizer::Tokenizer(){ initKeywords(); }
 static bool isIdentStart(char c){ return std::isalpha((unsigned char)c) || c=='_'; }
 static bool isIdentChar(char c){ return std::isalnum((unsigned char)c) || c=='_'; }
 
+static bool isTwoCharOp(char a, char b){
+    switch (a){
+        case '<': return b=='<' || b=='=';
+        case '>': return b=='>' || b=='=';
+        case '=': case '!': return b=='=';
+        case '&': return b=='&';
+        case '|': return b=='|';
+        case '+': return b=='=' || b=='+';
+        case '-': return b=='=' || b=='-' || b=='>';
+        case ':': return b==':';
+        default: return false;
+    }
+}
+
+// Sink for vector<Token>: writes into slot `count`, reusing the slot's string buffer when it exists
+struct TokenVectorSink {
+    std::vector<Token> &out;
+    const std::string &line;
+    size_t count = 0;
+    void operator()(TokType type, size_t pos, size_t len, int /*kw*/){
+        if (count < out.size()){
+            out[count].type = type;
+            out[count].value.assign(line, pos, len);
+            out[count].pos = (uint32_t)pos;
+            out[count].flags = 0;
+        } else {
+            out.push_back({type, line.substr(pos, len), (uint32_t)pos});
+        }
+        ++count;
+    }
+};
+
+// Sink for TokenStream: appends spans and folds the kind/keyword summary
+struct TokenStreamSink {
+    TokenStream &out;
+    void operator()(TokType type, size_t pos, size_t len, int kw){
+        out.kinds.push_back((uint8_t)type);
+        out.offsets.push_back((uint32_t)pos);
+        out.lengths.push_back((uint32_t)len);
+        out.keywordIds.push_back((int8_t)kw);
+        out.summary.kinds |= LineSummary::kindBit(type);
+        if (kw >= 0) out.summary.keywords |= (uint64_t)1 << kw;
+    }
+};
+
 std::vector<Token> Tokenizer::tokenize(const std::string &line) const {
     std::vector<Token> tokens;
+    tokenize(line, tokens);
+    return tokens;
+}
+
+void Tokenizer::tokenize(const std::string &line, std::vector<Token> &tokens) const {
+    TokenVectorSink sink{tokens, line};
+    lex(line, sink);
+    tokens.resize(sink.count);
+}
+
+void Tokenizer::tokenize(const std::string &line, TokenStream &out) const {
+    out.clear();
+    out.source = line;
+    TokenStreamSink sink{out};
+    lex(line, sink);
+}
+
+template <class Sink>
+void Tokenizer::lex(const std::string &line, Sink &emit) const {
+    std::string lw; // keyword lookup key; keywords are short enough to stay in SSO storage
     size_t i=0, n=line.size();
+    // Non-ASCII bytes only need UTF-8 decoding on lines that actually contain them
+    const bool ascii = utf8IsAscii(line.data(), n);
+    // Length of a valid multibyte UTF-8 character at position k (0 if none)
+    auto mb = [&](size_t k) -> size_t {
+        return ascii ? 0 : utf8SequenceLength(line.data() + k, n - k);
+    };
     while (i<n){
         unsigned char c = line[i];
         if (std::isspace(c)){
             size_t j=i; while (j<n && std::isspace((unsigned char)line[j])) ++j;
-            tokens.push_back({TokType::WHITESPACE, line.substr(i, j-i)});
+            emit(TokType::WHITESPACE, i, j-i, -1);
             i=j; continue;
         }
         // Comments
         if (c=='/' && i+1<n && line[i+1]=='/'){
-            tokens.push_back({TokType::COMMENT, line.substr(i)});
+            emit(TokType::COMMENT, i, n-i, -1);
             break;
         }
         // Preprocessor - only tokenize the '#' character
         if (c=='#'){
-            tokens.push_back({TokType::PREPROCESSOR, "#"});
+            emit(TokType::PREPROCESSOR, i, 1, -1);
             ++i; continue;
         }
         // String or char literal
         if (c=='"' || c=='\''){
             char q = (char)c; size_t j=i+1;
             while (j<n){ if (line[j]=='\\') { j+=2; } else if (line[j]==q) { ++j; break; } else ++j; }
-            tokens.push_back({TokType::STRING_LITERAL, line.substr(i, j-i)});
+            if (j>n) j=n;
+            emit(TokType::STRING_LITERAL, i, j-i, -1);
             i=j; continue;
         }
         // Two-char operators (must check BEFORE single-char operators)
-        if (i+1<n){
-            std::string two = line.substr(i,2);
-            static const std::unordered_set<std::string> twos = {"<<", ">>", "<=", ">=", "==", "!=", "&&", "||", "+=", "-=", "++", "--", "->", "::"};
-            if (twos.count(two)){
-                tokens.push_back({TokType::OPERATOR, two}); i+=2; continue;
-            }
+        if (i+1<n && isTwoCharOp((char)c, line[i+1])){
+            emit(TokType::OPERATOR, i, 2, -1); i+=2; continue;
         }
         // Separators and single char punctuation
         if (strchr("(){}[];,:.", c)){
-            std::string s(1,(char)c);
-            tokens.push_back({TokType::SEPARATOR, s}); ++i; continue;
+            emit(TokType::SEPARATOR, i, 1, -1); ++i; continue;
         }
         // Single-char operators
         if (strchr("+-=*/%<>!&|^~?:", c)){
-            tokens.push_back({TokType::OPERATOR, std::string(1,(char)c)}); ++i; continue;
+            emit(TokType::OPERATOR, i, 1, -1); ++i; continue;
         }
         // Identifier or Keyword - ROBUST: stop at boundary (operator, separator, digit)
-        if (isIdentStart(c)){
-            size_t j=i+1; // Start after the first valid identifier char
+        // Valid UTF-8 multibyte characters count as identifier characters
+        size_t startLen = isIdentStart(c) ? 1 : (c >= 0x80 ? mb(i) : 0);
+        if (startLen){
+            size_t j=i+startLen; // Start after the first valid identifier char
             // Consume identifier characters, but STOP at non-identifier chars
-            while (j<n && isIdentChar(line[j])) {
-                ++j;
+            while (j<n) {
+                if (isIdentChar(line[j])) { ++j; continue; }
+                size_t len = ((unsigned char)line[j] >= 0x80) ? mb(j) : 0;
+                if (!len) break;
+                j += len;
+            }
+            int kw = -1;
+            if (j-i <= maxKeywordLen_){
+                lw.assign(line, i, j-i);
+                std::transform(lw.begin(), lw.end(), lw.begin(), [](unsigned char ch){ return (char)std::tolower(ch); });
+                auto it = keywords_.find(lw);
+                if (it != keywords_.end()) kw = it->second;
             }
-            std::string w = line.substr(i, j-i);
-            std::string lw = w; std::transform(lw.begin(), lw.end(), lw.begin(), [](unsigned char ch){ return (char)std::tolower(ch); });
-            if (keywords_.count(lw)) tokens.push_back({TokType::KEYWORD, w});
-            else tokens.push_back({TokType::IDENTIFIER, w});
+            emit(kw >= 0 ? TokType::KEYWORD : TokType::IDENTIFIER, i, j-i, kw);
             i=j; continue;
         }
         // Number - ROBUST: stop at boundary (identifier, operator, separator)
@@ -83,10 +170,14 @@ std::vector<Token> Tokenizer::tokenize(const std::string &line) const {
             while (j<n && (std::isdigit((unsigned char)line[j]) || line[j]=='.')) {
                 ++j;
             }
-            tokens.push_back({TokType::NUMBER, line.substr(i, j-i)}); i=j; continue;
+            emit(TokType::NUMBER, i, j-i, -1); i=j; continue;
         }
-        // Fallback
-    tokens.push_back({TokType::UNKNOWN, std::string(1,(char)c)}); ++i;
+        // Fallback: a run of invalid UTF-8 bytes becomes one token, other bytes one each
+        if (c >= 0x80){
+            size_t j=i+1;
+            while (j<n && (unsigned char)line[j] >= 0x80 && !mb(j)) ++j;
+            emit(TokType::UNKNOWN, i, j-i, -1); i=j; continue;
+        }
+        emit(TokType::UNKNOWN, i, 1, -1); ++i;
     }
-    return tokens;
 }
@@ -1,7 +1,8 @@
 #pragma once
+#include <cstdint>
 #include <string>
 #include <vector>
-#include <unordered_set>
+#include <unordered_map>
 
 // Token types for the tokenizer and downstream analysis
 enum class TokType {
@@ -17,11 +18,20 @@ enum class TokType {
     UNKNOWN
 };
 
+// Token::flags bits
+enum TokenFlag : uint8_t {
+    TOKEN_DECLARED = 1, // identifier names a symbol declared in a visible scope
+};
+
 struct Token {
     TokType type;
     std::string value;
+    uint32_t pos = 0; // byte offset in the source line (inserted tokens: where they were inserted)
+    uint8_t flags = 0; // TokenFlag bits
 };
 
+class TokenStream;
+
 // Lightweight tokenizer implemented as a small FSM
 class Tokenizer {
 public:
@@ -30,7 +40,23 @@ public:
     // Tokenize a single line of C++ source into tokens
     std::vector<Token> tokenize(const std::string &line) const;
 
+    // Tokenize into a caller-owned buffer. Existing Token slots (and their string
+    // capacity) are reused, so a buffer kept across lines stops growing once it has
+    // seen the longest line.
+    void tokenize(const std::string &line, std::vector<Token> &out) const;
+
+    // Tokenize into a struct-of-arrays stream (spans into `line`, which must outlive it)
+    void tokenize(const std::string &line, TokenStream &out) const;
+
+    // Keyword id (0..63) for a word, compared case-insensitively; -1 if not a keyword
+    int keywordId(const std::string &word) const;
+
 private:
-    std::unordered_set<std::string> keywords_;
+    std::unordered_map<std::string, int> keywords_; // lowercase keyword -> id
+    size_t maxKeywordLen_ = 0;
     void initKeywords();
+
+    // Core FSM: reports each token as (type, offset, length, keyword id) to the sink
+    template <class Sink>
+    void lex(const std::string &line, Sink &sink) const;
 };
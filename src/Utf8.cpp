@@ -0,0 +1,75 @@
+#include "Utf8.h"
+#include <cstdint>
+#include <cstring>
+
+bool utf8IsAscii(const char *p, size_t n){
+    const uint64_t high = 0x8080808080808080ULL;
+    size_t i = 0;
+    // OR eight bytes at a time together and test their high bits once
+    for (; i + 32 <= n; i += 32){
+        uint64_t a, b, c, d;
+        std::memcpy(&a, p + i, 8);
+        std::memcpy(&b, p + i + 8, 8);
+        std::memcpy(&c, p + i + 16, 8);
+        std::memcpy(&d, p + i + 24, 8);
+        if ((a | b | c | d) & high) return false;
+    }
+    for (; i + 8 <= n; i += 8){
+        uint64_t a;
+        std::memcpy(&a, p + i, 8);
+        if (a & high) return false;
+    }
+    for (; i < n; ++i){
+        if ((unsigned char)p[i] & 0x80) return false;
+    }
+    return true;
+}
+
+static bool isCont(unsigned char c){ return (c & 0xC0) == 0x80; }
+
+size_t utf8SequenceLength(const char *p, size_t avail){
+    if (avail < 2) return 0;
+    const unsigned char c0 = (unsigned char)p[0];
+    const unsigned char c1 = (unsigned char)p[1];
+    if (c0 >= 0xC2 && c0 <= 0xDF) return isCont(c1) ? 2 : 0;
+    if (c0 >= 0xE0 && c0 <= 0xEF){
+        if (avail < 3) return 0;
+        // E0 needs A0..BF (no overlongs), ED needs 80..9F (no surrogates)
+        unsigned char lo = (c0 == 0xE0) ? 0xA0 : 0x80;
+        unsigned char hi = (c0 == 0xED) ? 0x9F : 0xBF;
+        if (c1 < lo || c1 > hi) return 0;
+        return isCont((unsigned char)p[2]) ? 3 : 0;
+    }
+    if (c0 >= 0xF0 && c0 <= 0xF4){
+        if (avail < 4) return 0;
+        // F0 needs 90..BF (no overlongs), F4 needs 80..8F (max U+10FFFF)
+        unsigned char lo = (c0 == 0xF0) ? 0x90 : 0x80;
+        unsigned char hi = (c0 == 0xF4) ? 0x8F : 0xBF;
+        if (c1 < lo || c1 > hi) return 0;
+        return (isCont((unsigned char)p[2]) && isCont((unsigned char)p[3])) ? 4 : 0;
+    }
+    return 0;
+}
+
+size_t utf16Length(const char *p, size_t n){
+    if (utf8IsAscii(p, n)) return n;
+    size_t units = 0;
+    for (size_t i=0; i<n;){
+        size_t len = ((unsigned char)p[i] & 0x80) ? utf8SequenceLength(p + i, n - i) : 0;
+        units += len == 4 ? 2 : 1;
+        i += len ? len : 1;
+    }
+    return units;
+}
+
+size_t utf16ToByteOffset(const char *p, size_t n, size_t units){
+    size_t i = 0;
+    while (i < n){
+        size_t len = ((unsigned char)p[i] & 0x80) ? utf8SequenceLength(p + i, n - i) : 0;
+        size_t w = len == 4 ? 2 : 1;
+        if (units < w) break;
+        units -= w;
+        i += len ? len : 1;
+    }
+    return i;
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <cstddef>
+
+// True if none of the n bytes at p has the high bit set. Checks 8 bytes per step.
+bool utf8IsAscii(const char *p, size_t n);
+
+// Length (2..4) of the well-formed UTF-8 multibyte sequence at p, looking at no
+// more than `avail` bytes; 0 if p does not start a valid multibyte sequence
+// (ASCII, stray continuation byte, overlong form, surrogate, truncated, > U+10FFFF).
+size_t utf8SequenceLength(const char *p, size_t avail);
+
+// UTF-16 code units in the first n bytes of p (LSP positions count these).
+// A byte that starts no valid sequence counts as one unit.
+size_t utf16Length(const char *p, size_t n);
+
+// Byte offset of UTF-16 column `units` in the n bytes at p, clamped to n. A
+// column inside a surrogate pair maps to the start of its character.
+size_t utf16ToByteOffset(const char *p, size_t n, size_t units);
@@ -3,16 +3,21 @@
 #include <cctype>
 #include <sstream>
 #include <cstring>
+#include <cstdio>
+#include <memory>
 #include <iostream>
+#include <thread>
 
 Analyzer::Analyzer(Trie &trie, SymbolTable &sym, Logger &logger)
     : trie_(trie), sym_(sym), log_(logger), autocorrect_(trie, sym, logger) {
     seedDictionary();
+    registerRules();
 }
 
 void Analyzer::seedDictionary(){
-    // Use the Trie's built-in prioritized dictionary
-    trie_.loadDefaultDictionary();
+    // Use the Trie's built-in prioritized dictionary. A trie that is already
+    // loaded is left untouched, so several Analyzers can share one read-only trie.
+    if (trie_.allWords().empty()) trie_.loadDefaultDictionary();
 }
 
 static std::string toLower(std::string s){
@@ -69,7 +74,109 @@ std::string Analyzer::correctTokenClosest(const std::string &tok, int maxDist, s
     return tok;
 }
 
-void Analyzer::fixInclude(std::vector<Token> &tokens, std::vector<std::string> &issues){
+// 1-based source column of token i (for Issue records)
+static uint32_t columnOf(const TokenRewriter &tokens, size_t i){
+    return tokens[i].pos + 1;
+}
+
+// True if fixInclude could change this line (first token '#' or an include-like word)
+static bool isIncludeCandidate(const TokenStream &ts){
+    size_t first = ts.nextMeaningful(0);
+    if (first >= ts.size()) return false;
+    TokType t = ts.kind(first);
+    if (t == TokType::PREPROCESSOR) return true;
+    // 'include' itself or a typo within edit distance 2 of it (so length 5..9)
+    if (t == TokType::KEYWORD || t == TokType::IDENTIFIER){
+        uint32_t len = ts.lengths[first];
+        return len >= 5 && len <= 9;
+    }
+    return false;
+}
+
+// Bump when a change outside this file (Tokenizer, RuleEngine, Autocorrect)
+// changes what the rules produce; this file's own changes reach rulesVersion()
+// through its build time
+static const char kRulesVersion[] = "intellifix-rules-2";
+
+std::string Analyzer::rulesVersion(){
+    return std::string(kRulesVersion) + " " + __DATE__ + " " + __TIME__;
+}
+
+void Analyzer::registerRules(){
+    // Most passes only need the line's tokens; adapt them to the engine's callbacks
+    auto line = [this](void (Analyzer::*fn)(TokenRewriter &, IssueList &)){
+        return [this, fn](RuleContext &ctx, IssueList &out){ (this->*fn)(ctx.rewriter, out); };
+    };
+    auto token = [this](size_t (Analyzer::*fn)(TokenRewriter &, size_t, IssueList &)){
+        return [this, fn](RuleContext &ctx, size_t i, IssueList &out){ return (this->*fn)(ctx.rewriter, i, out); };
+    };
+    const uint32_t words = LineSummary::kindBit(TokType::IDENTIFIER) | LineSummary::kindBit(TokType::KEYWORD);
+    auto kw = [this](const char *w){ return (uint64_t)1 << tokenizer_.keywordId(w); };
+
+    // Declaration detection (see scanScopes)
+    for (const char *t : {"int", "float", "double", "char", "void", "auto", "string", "vector", "map", "unordered_map", "pair", "queue", "stack"}) typeKeywords_ |= kw(t);
+    recordKeywords_ = kw("struct") | kw("class");
+
+    // 1) Include directives first (adds missing #). fixInclude's trailing fixPatterns
+    //    call cannot fire on tokenizer output (STL type names are always KEYWORD
+    //    tokens), so lines that are not include candidates can skip it entirely
+    Rule include;
+    include.name = "fixInclude";
+    include.when = [](const RuleContext &ctx){ return isIncludeCandidate(ctx.stream); };
+    include.onLine = line(&Analyzer::fixInclude);
+    engine_.add(include);
+
+    // 2) Word/identifier corrections
+    Rule common;
+    common.name = "fixCommonIdentifierTypos";
+    common.scope = Rule::Scope::TOKEN;
+    common.pattern.kinds = LineSummary::kindBit(TokType::IDENTIFIER);
+    common.rewritesWords = true;
+    common.onToken = token(&Analyzer::fixCommonIdentifierTypoAt);
+    engine_.add(common);
+
+    Rule idents;
+    idents.name = "fixIdentifiers";
+    idents.scope = Rule::Scope::TOKEN;
+    idents.pattern.kinds = words;
+    idents.rewritesWords = true;
+    idents.onToken = [this](RuleContext &ctx, size_t i, IssueList &out){ return fixIdentifierAt(ctx.rewriter, i, out, ctx.memo); };
+    engine_.add(idents);
+
+    // 3) Operator & stream fixes. Stream typos (cot, cn, ...) are rewritten to
+    //    cout/cin by the word rules, so the line needs cout/cin or a rewrite (the
+    //    engine drops the keyword gate while a word rule is disabled)
+    Rule stream;
+    stream.name = "fixStreamOperators";
+    stream.scope = Rule::Scope::TOKEN;
+    stream.pattern.kinds = words;
+    stream.pattern.keywords = kw("cout") | kw("cin");
+    stream.pattern.afterRewrite = true;
+    stream.onToken = token(&Analyzer::fixStreamOperatorsAt);
+    engine_.add(stream);
+
+    Rule charLits;
+    charLits.name = "fixInvalidCharLiterals";
+    charLits.scope = Rule::Scope::TOKEN;
+    charLits.pattern.kinds = LineSummary::kindBit(TokType::STRING_LITERAL);
+    charLits.onToken = token(&Analyzer::fixInvalidCharLiteralAt);
+    engine_.add(charLits);
+
+    Rule forLoop;
+    forLoop.name = "fixForLoop";
+    forLoop.pattern.keywords = kw("for");
+    forLoop.pattern.afterRewrite = true;
+    forLoop.onLine = line(&Analyzer::fixForLoop);
+    engine_.add(forLoop);
+
+    // 4) Pattern fixes (semicolons) - must be after fixInclude
+    Rule semicolon;
+    semicolon.name = "addMissingSemicolon";
+    semicolon.onLine = line(&Analyzer::addMissingSemicolon);
+    engine_.add(semicolon);
+}
+
+void Analyzer::fixInclude(TokenRewriter &tokens, IssueList &issues){
     if (tokens.empty()) return;
     
     // Find first meaningful (non-whitespace) token
@@ -83,34 +190,35 @@ void Analyzer::fixInclude(std::vector<Token> &tokens, std::vector<std::string> &
     
     if (firstMeaningful == -1) return; // Empty or whitespace-only line
     
-    Token &firstToken = tokens[firstMeaningful];
+    // tokens[firstMeaningful] is read through the index: once '#' is inserted, the
+    // checks below see '#' in that slot
     
     // Check if line starts with "include" keyword or typo of "include" (missing #)
-    if ((firstToken.type == TokType::KEYWORD || firstToken.type == TokType::IDENTIFIER) && 
-        (firstToken.value == "include")) {
+    if ((tokens[firstMeaningful].type == TokType::KEYWORD || tokens[firstMeaningful].type == TokType::IDENTIFIER) && 
+        (tokens[firstMeaningful].value == "include")) {
         // Insert '#' right before the 'include' token (at firstMeaningful position)
-        tokens.insert(tokens.begin() + firstMeaningful, {TokType::PREPROCESSOR, "#"});
-        issues.push_back("added missing '#' before include");
+        tokens.insert(firstMeaningful, {TokType::PREPROCESSOR, "#"});
+        issues.add(IssueCode::INCLUDE_HASH_ADDED, columnOf(tokens, firstMeaningful));
         // continue to check angle brackets if present
     }
     
     // Check for typos of "include" (like "incldue", "inclde") missing #
-    if (firstToken.type == TokType::IDENTIFIER && firstToken.value != "include") {
-        auto suggestions = trie_.getSuggestions(firstToken.value, 2);
+    if (tokens[firstMeaningful].type == TokType::IDENTIFIER && tokens[firstMeaningful].value != "include") {
+        auto suggestions = trie_.getSuggestions(tokens[firstMeaningful].value, 2);
         if (!suggestions.empty() && suggestions[0] == "include") {
             // This is a typo of "include" - fix it and add #
-            issues.push_back("identifier '" + firstToken.value + "' -> 'include'");
-            firstToken.value = "include";
-            firstToken.type = TokType::KEYWORD;
+            issues.add(IssueCode::IDENTIFIER, columnOf(tokens, firstMeaningful), tokens[firstMeaningful].value, "include");
+            tokens[firstMeaningful].value = "include";
+            tokens[firstMeaningful].type = TokType::KEYWORD;
             // Insert '#' before it
-            tokens.insert(tokens.begin() + firstMeaningful, {TokType::PREPROCESSOR, "#"});
-            issues.push_back("added missing '#' before include");
+            tokens.insert(firstMeaningful, {TokType::PREPROCESSOR, "#"});
+            issues.add(IssueCode::INCLUDE_HASH_ADDED, columnOf(tokens, firstMeaningful));
             // continue to check angle brackets if present
         }
     }
     
     // Check if line starts with '#' followed by 'include' (or typo of include)
-    if (firstToken.type == TokType::PREPROCESSOR && firstToken.value == "#") {
+    if (tokens[firstMeaningful].type == TokType::PREPROCESSOR && tokens[firstMeaningful].value == "#") {
         // Find next meaningful token after '#'
         int nextMeaningful = -1;
         for (size_t i = firstMeaningful + 1; i < tokens.size(); ++i) {
@@ -128,7 +236,7 @@ void Analyzer::fixInclude(std::vector<Token> &tokens, std::vector<std::string> &
             if (nextVal != "include") {
                 auto suggestions = trie_.getSuggestions(nextVal, 2);
                 if (!suggestions.empty() && suggestions[0] == "include") {
-                    issues.push_back("identifier '" + nextVal + "' -> 'include'");
+                    issues.add(IssueCode::IDENTIFIER, columnOf(tokens, nextMeaningful), nextVal, "include");
                     nextVal = "include";
                 }
             }
@@ -177,8 +285,8 @@ void Analyzer::fixInclude(std::vector<Token> &tokens, std::vector<std::string> &
                             if ((tokens[afterHeader].type == TokType::OPERATOR || tokens[afterHeader].type == TokType::SEPARATOR) && tokens[afterHeader].value == ">") hasClosing = true;
                         }
                         if (!hasClosing){
-                            tokens.insert(tokens.begin() + headerIdx + 1, {TokType::OPERATOR, ">"});
-                            issues.push_back("inserted missing '>' in #include<...>");
+                            tokens.insert(headerIdx + 1, {TokType::OPERATOR, ">"});
+                            issues.add(IssueCode::INCLUDE_ANGLE_CLOSED, columnOf(tokens, headerIdx + 1));
                         }
                     }
                 }
@@ -187,10 +295,12 @@ void Analyzer::fixInclude(std::vector<Token> &tokens, std::vector<std::string> &
     }
 
     // Delegate other include fixes to Autocorrect's pattern fixes
-    autocorrect_.fixPatterns(tokens, issues);
+    std::vector<std::string> notes;
+    autocorrect_.fixPatterns(tokens.flat(), notes);
+    for (auto &note : notes) issues.add(IssueCode::NOTE, 0, note);
 }
 
-void Analyzer::fixForLoop(std::vector<Token> &tokens, std::vector<std::string> &issues){
+void Analyzer::fixForLoop(TokenRewriter &tokens, IssueList &issues){
     for (size_t i = 0; i < tokens.size(); ++i) {
         if (tokens[i].type == TokType::KEYWORD && tokens[i].value == "for") {
             size_t j = i + 1;
@@ -228,7 +338,7 @@ void Analyzer::fixForLoop(std::vector<Token> &tokens, std::vector<std::string> &
                                 inner_paren_level--;
                             } else if (tokens[l].value == "," && inner_paren_level == 0) {
                                 tokens[l].value = ";";
-                                issues.push_back("for(...) comma -> semicolon");
+                                issues.add(IssueCode::FOR_COMMA, columnOf(tokens, l));
                             }
                         }
                     }
@@ -287,8 +397,8 @@ void Analyzer::fixForLoop(std::vector<Token> &tokens, std::vector<std::string> &
                             }
                             
                             // Insert first semicolon AFTER init_end (which is end of init expression)
-                            tokens.insert(tokens.begin() + init_end + 1, {TokType::SEPARATOR, ";"});
-                            issues.push_back("for(...) inserted first semicolon after init");
+                            tokens.insert(init_end + 1, {TokType::SEPARATOR, ";"});
+                            issues.add(IssueCode::FOR_FIRST_SEMICOLON, columnOf(tokens, init_end + 1));
                             for_loop_end++; // Adjust end position
                             first_comparison++; // Adjust comparison position
 
@@ -303,8 +413,8 @@ void Analyzer::fixForLoop(std::vector<Token> &tokens, std::vector<std::string> &
                             if (right_operand < for_loop_end && 
                                 (tokens[right_operand].type == TokType::NUMBER || 
                                  tokens[right_operand].type == TokType::IDENTIFIER)) {
-                                tokens.insert(tokens.begin() + right_operand + 1, {TokType::SEPARATOR, ";"});
-                                issues.push_back("for(...) inserted second semicolon after condition");
+                                tokens.insert(right_operand + 1, {TokType::SEPARATOR, ";"});
+                                issues.add(IssueCode::FOR_SECOND_SEMICOLON, columnOf(tokens, right_operand + 1));
                                 for_loop_end++; // Adjust end position
                             }
                         }
@@ -357,8 +467,8 @@ void Analyzer::fixForLoop(std::vector<Token> &tokens, std::vector<std::string> &
                             
                             // Insert semicolon AFTER the comparison value
                             if (comparison_end < for_loop_end) {
-                                tokens.insert(tokens.begin() + comparison_end, {TokType::SEPARATOR, ";"});
-                                issues.push_back("for(...) inserted missing second semicolon");
+                                tokens.insert(comparison_end, {TokType::SEPARATOR, ";"});
+                                issues.add(IssueCode::FOR_MISSING_SEMICOLON, columnOf(tokens, comparison_end));
                                 for_loop_end++; // Adjust end position
                             }
                         }
@@ -377,246 +487,238 @@ void Analyzer::fixForLoop(std::vector<Token> &tokens, std::vector<std::string> &
 // cin > x;         -> cin >> x;
 // cin >x;          -> cin >> x;
 // Works with both '"' and '\'' string literals; applies when a single '<'/'>' is present.
-void Analyzer::fixStreamOperators(std::vector<Token> &tokens, std::vector<std::string> &issues){
+size_t Analyzer::fixStreamOperatorsAt(TokenRewriter &tokens, size_t i, IssueList &issues){
     // Robust logic: Fix ANY wrong operator after cout/cin AND continue fixing chain
-    for (size_t i = 0; i < tokens.size(); ++i) {
-        // Skip comments and string literals
-        if (tokens[i].type == TokType::COMMENT || tokens[i].type == TokType::STRING_LITERAL) {
-            continue;
-        }
-        
-        // Check for cout (or typos like cot, cut, ocout)
-        if (tokens[i].type == TokType::IDENTIFIER || tokens[i].type == TokType::KEYWORD) {
-            std::string lowerVal = tokens[i].value;
-            std::transform(lowerVal.begin(), lowerVal.end(), lowerVal.begin(), 
-                          [](unsigned char c){ return (char)std::tolower(c); });
+    // (the rule is only called for IDENTIFIER/KEYWORD tokens, never comments or literals)
+    // Check for cout (or typos like cot, cut, ocout); a declared 'out' is a variable
+    if (tokens[i].flags & TOKEN_DECLARED) return 0;
+    std::string lowerVal = tokens[i].value;
+    std::transform(lowerVal.begin(), lowerVal.end(), lowerVal.begin(), 
+                  [](unsigned char c){ return (char)std::tolower(c); });
+    
+    if (lowerVal == "cout" || lowerVal == "cot" || lowerVal == "cut" || 
+        lowerVal == "ocout" || lowerVal == "out" || lowerVal == "ct") {
+        // Fix ALL operators in the cout chain until we hit semicolon/separator
+        size_t idx = i + 1;
+        while (idx < tokens.size()) {
+            // Skip whitespace
+            if (tokens[idx].type == TokType::WHITESPACE) {
+                idx++;
+                continue;
+            }
             
-            if (lowerVal == "cout" || lowerVal == "cot" || lowerVal == "cut" || 
-                lowerVal == "ocout" || lowerVal == "out" || lowerVal == "ct") {
-                // Fix ALL operators in the cout chain until we hit semicolon/separator
-                size_t idx = i + 1;
-                while (idx < tokens.size()) {
-                    // Skip whitespace
-                    if (tokens[idx].type == TokType::WHITESPACE) {
-                        idx++;
-                        continue;
-                    }
-                    
-                    // Stop at semicolon, brace, or end of statement
-                    if (tokens[idx].type == TokType::SEPARATOR && 
-                        (tokens[idx].value == ";" || tokens[idx].value == "{" || 
-                         tokens[idx].value == "}" || tokens[idx].value == "," ||
-                         tokens[idx].value == ")" || tokens[idx].value == "(")) {
-                        break;
-                    }
-                    
-                    // Fix single-char operators or ':' to "<<"
-                    if (tokens[idx].type == TokType::OPERATOR ||
-                        (tokens[idx].type == TokType::SEPARATOR && tokens[idx].value == ":")) {
-                        std::string op = tokens[idx].value;
-                        // Preserve existing correct operator and ++/--
-                        if (op == "<<" || op == "++" || op == "--") {
-                            // ok
-                        } else if (op.length() == 1 || op == ":") {
-                            issues.push_back("stream operator '" + op + "' -> '<<' in cout chain");
-                            tokens[idx].value = "<<";
-                        }
-                    }
-                    
-                    idx++;
+            // Stop at semicolon, brace, or end of statement
+            if (tokens[idx].type == TokType::SEPARATOR && 
+                (tokens[idx].value == ";" || tokens[idx].value == "{" || 
+                 tokens[idx].value == "}" || tokens[idx].value == "," ||
+                 tokens[idx].value == ")" || tokens[idx].value == "(")) {
+                break;
+            }
+            
+            // Fix single-char operators or ':' to "<<"
+            if (tokens[idx].type == TokType::OPERATOR ||
+                (tokens[idx].type == TokType::SEPARATOR && tokens[idx].value == ":")) {
+                std::string op = tokens[idx].value;
+                // Preserve existing correct operator and ++/--
+                if (op == "<<" || op == "++" || op == "--") {
+                    // ok
+                } else if (op.length() == 1 || op == ":") {
+                    issues.add(IssueCode::COUT_OPERATOR, columnOf(tokens, idx), op);
+                    tokens[idx].value = "<<";
                 }
             }
-            // Check for cin (or typos like cn, cinn)
-            else if (lowerVal == "cin" || lowerVal == "cn" || lowerVal == "cinn") {
-                // Fix ALL operators in the cin chain until we hit semicolon/separator
-                size_t idx = i + 1;
-                while (idx < tokens.size()) {
-                    // Skip whitespace
-                    if (tokens[idx].type == TokType::WHITESPACE) {
-                        idx++;
-                        continue;
-                    }
-                    
-                    // Stop at semicolon, brace, or end of statement
-                    if (tokens[idx].type == TokType::SEPARATOR && 
-                        (tokens[idx].value == ";" || tokens[idx].value == "{" || 
-                         tokens[idx].value == "}" || tokens[idx].value == "," ||
-                         tokens[idx].value == ")" || tokens[idx].value == "(")) {
-                        break;
-                    }
-                    
-                    // Fix single-char operators or ':' to ">>"
-                    if (tokens[idx].type == TokType::OPERATOR ||
-                        (tokens[idx].type == TokType::SEPARATOR && tokens[idx].value == ":")) {
-                        std::string op = tokens[idx].value;
-                        // Preserve existing correct operator and ++/--
-                        if (op == ">>" || op == "++" || op == "--") {
-                            // ok
-                        } else if (op.length() == 1 || op == ":") {
-                            issues.push_back("stream operator '" + op + "' -> '>>' in cin chain");
-                            tokens[idx].value = ">>";
-                        }
-                    }
-                    
-                    idx++;
+            
+            idx++;
+        }
+    }
+    // Check for cin (or typos like cn, cinn)
+    else if (lowerVal == "cin" || lowerVal == "cn" || lowerVal == "cinn") {
+        // Fix ALL operators in the cin chain until we hit semicolon/separator
+        size_t idx = i + 1;
+        while (idx < tokens.size()) {
+            // Skip whitespace
+            if (tokens[idx].type == TokType::WHITESPACE) {
+                idx++;
+                continue;
+            }
+            
+            // Stop at semicolon, brace, or end of statement
+            if (tokens[idx].type == TokType::SEPARATOR && 
+                (tokens[idx].value == ";" || tokens[idx].value == "{" || 
+                 tokens[idx].value == "}" || tokens[idx].value == "," ||
+                 tokens[idx].value == ")" || tokens[idx].value == "(")) {
+                break;
+            }
+            
+            // Fix single-char operators or ':' to ">>"
+            if (tokens[idx].type == TokType::OPERATOR ||
+                (tokens[idx].type == TokType::SEPARATOR && tokens[idx].value == ":")) {
+                std::string op = tokens[idx].value;
+                // Preserve existing correct operator and ++/--
+                if (op == ">>" || op == "++" || op == "--") {
+                    // ok
+                } else if (op.length() == 1 || op == ":") {
+                    issues.add(IssueCode::CIN_OPERATOR, columnOf(tokens, idx), op);
+                    tokens[idx].value = ">>";
                 }
             }
+            
+            idx++;
         }
     }
+    return 0;
 }
 
 // Fix invalid single-quoted strings: 'hello' -> "hello" (multi-char must use double quotes)
 // Valid char literals like 'a' stay as 'a'
-void Analyzer::fixInvalidCharLiterals(std::vector<Token> &tokens, std::vector<std::string> &issues){
-    for (size_t i = 0; i < tokens.size(); ++i) {
-        if (tokens[i].type == TokType::STRING_LITERAL) {
-            std::string& val = tokens[i].value;
-            
-            // Check if it's single-quoted
-            if (val.length() >= 2 && val[0] == '\'' && val.back() == '\'') {
-                // Extract content between quotes
-                std::string content = val.substr(1, val.length() - 2);
-                
-                // If content is NOT exactly 1 character, it should be double-quoted
-                // Special case: empty '', or multi-char 'hello'
-                if (content.length() != 1) {
-                    issues.push_back("invalid char literal '" + val + "' -> \"" + content + "\" (multi-char needs double quotes)");
-                    tokens[i].value = "\"" + content + "\"";
-                }
-            }
+size_t Analyzer::fixInvalidCharLiteralAt(TokenRewriter &tokens, size_t i, IssueList &issues){
+    std::string& val = tokens[i].value;
+    
+    // Check if it's single-quoted
+    if (val.length() >= 2 && val[0] == '\'' && val.back() == '\'') {
+        // Extract content between quotes
+        std::string content = val.substr(1, val.length() - 2);
+        
+        // If content is NOT exactly 1 character, it should be double-quoted
+        // Special case: empty '', or multi-char 'hello'
+        if (content.length() != 1) {
+            issues.add(IssueCode::CHAR_LITERAL, columnOf(tokens, i), val, content);
+            tokens[i].value = "\"" + content + "\"";
         }
     }
+    return 0;
 }
 
 // Fix a short list of common identifier typos prior to suggestion stage
 // e.g., mian->main, mnia->main, cot->cout, cut->cout, out->cout, ct->cout, cinn->cin
-void Analyzer::fixCommonIdentifierTypos(std::vector<Token> &tokens, std::vector<std::string> &issues){
-    // Simple hard-coded replacements at token level (skip comments and string literals)
-    for (auto &t : tokens){
-        // Skip tokens in comments and string literals
-        if (t.type == TokType::COMMENT || t.type == TokType::STRING_LITERAL) continue;
-        
-        if (t.type==TokType::IDENTIFIER){
-            std::string lw = t.value; std::transform(lw.begin(), lw.end(), lw.begin(), [](unsigned char c){ return (char)std::tolower(c); });
-            if (lw=="mian" || lw=="mnia") { issues.push_back("identifier '"+t.value+"' -> 'main'"); t.value = "main"; }
-            else if (lw=="cot"||lw=="cut"||lw=="out"||lw=="ct") { issues.push_back("identifier '"+t.value+"' -> 'cout'"); t.value = "cout"; }
-            else if (lw=="cinn") { issues.push_back("identifier '"+t.value+"' -> 'cin'"); t.value = "cin"; }
-        }
-    }
+size_t Analyzer::fixCommonIdentifierTypoAt(TokenRewriter &tokens, size_t i, IssueList &issues){
+    // Simple hard-coded replacements at token level (only called for IDENTIFIER tokens,
+    // so comments and string literals are never touched)
+    Token &t = tokens[i];
+    if (t.flags & TOKEN_DECLARED) return 0; // a declared name is not a typo
+    std::string lw = t.value; std::transform(lw.begin(), lw.end(), lw.begin(), [](unsigned char c){ return (char)std::tolower(c); });
+    if (lw=="mian" || lw=="mnia") { issues.add(IssueCode::IDENTIFIER, columnOf(tokens, i), t.value, "main"); t.value = "main"; }
+    else if (lw=="cot"||lw=="cut"||lw=="out"||lw=="ct") { issues.add(IssueCode::IDENTIFIER, columnOf(tokens, i), t.value, "cout"); t.value = "cout"; }
+    else if (lw=="cinn") { issues.add(IssueCode::IDENTIFIER, columnOf(tokens, i), t.value, "cin"); t.value = "cin"; }
+    return 0;
 }
 
-void Analyzer::fixIdentifiers(std::vector<Token> &tokens, std::vector<std::string> &issues){
+// Known typos (fast lookup before the Trie)
+static const std::unordered_map<std::string, std::string> knownTypos = {
+    {"mian", "main"}, {"mnia", "main"}, {"nitmain", "main"},
+    {"cot", "cout"}, {"ocout", "cout"}, {"cut", "cout"}, {"ct", "cout"}, {"out", "cout"},
+    {"cn", "cin"}, {"cinn", "cin"},
+    {"retrun", "return"}, {"reutrn", "return"}, {"retun", "return"},
+    {"vecotr", "vector"}, {"vcetor", "vector"},
+    {"iotream", "iostream"}, {"iostraem", "iostream"},
+    {"incldue", "include"}, {"inlcude", "include"}, {"inlude", "include"}, {"inclde", "include"},
+    {"fi", "if"}, {"fr", "for"}, {"fo", "for"}, {"whle", "while"},  // Short keyword typos
+    {"defin", "define"}, {"namspace", "namespace"}, {"it", "int"}, {"intz", "int"}  // More typos
+};
+
+size_t Analyzer::fixIdentifierAt(TokenRewriter &tokens, size_t i, IssueList &issues, CorrectionMemo &memo){
     // **AGGRESSIVE LOGIC**: Check ALL identifiers with Trie (except in comments/strings)
     // This will catch: namspace, it, intz, cn, retun, etc.
     // Note: May cause i->if regression, but we'll fix that later with SymbolTable
+    // (only called for IDENTIFIER and KEYWORD tokens)
+
+    // Special case: "using namespacestd" -> "using namespace std" (missing space)
+    if (tokens[i].type == TokType::KEYWORD && tokens[i].value == "using"){
+        // find next meaningful token
+        size_t j = i + 1;
+        while (j < tokens.size() && tokens[j].type == TokType::WHITESPACE) ++j;
+        if (j < tokens.size() && tokens[j].type == TokType::IDENTIFIER){
+            std::string lw = tokens[j].value; std::transform(lw.begin(), lw.end(), lw.begin(), [](unsigned char c){ return (char)std::tolower(c); });
+            if (lw == "namespacestd"){
+                tokens[j].value = "namespace std"; // simple split in-place
+                tokens[j].type = TokType::KEYWORD;   // treat as keyword chunk for now
+                issues.add(IssueCode::IDENTIFIER, columnOf(tokens, j), "namespacestd", "namespace std");
+            }
+        }
+    }
+
+    // Names declared in a visible scope are the user's own: no split, no suggestions
+    if (tokens[i].flags & TOKEN_DECLARED) return 0;
+
+    std::string word = tokens[i].value;
+    std::string lowerWord = word;
+    std::transform(lowerWord.begin(), lowerWord.end(), lowerWord.begin(), 
+                  [](unsigned char c){ return (char)std::tolower(c); });
+
+    // Heuristic split: type merged with identifier (e.g., "intx" -> "int x")
+    if (tokens[i].type == TokType::IDENTIFIER && lowerWord.rfind("int", 0) == 0 && word.size() > 3){
+        std::string suffix = word.substr(3);
+        // suffix must start with a valid identifier char
+        if (!suffix.empty() && (std::isalpha((unsigned char)suffix[0]) || suffix[0]=='_')){
+            // Replace current token with 'int' keyword, insert space and suffix identifier
+            tokens[i].type = TokType::KEYWORD;
+            tokens[i].value = "int";
+            tokens.insert(i + 1, {TokType::WHITESPACE, " "});
+            tokens.insert(i + 2, {TokType::IDENTIFIER, suffix});
+            issues.add(IssueCode::SPLIT_INT, columnOf(tokens, i), word, suffix);
+            // Skip past the inserted tokens
+            return 2;
+        }
+    }
     
-    // First pass: Known typos (fast lookup)
-    static const std::unordered_map<std::string, std::string> knownTypos = {
-        {"mian", "main"}, {"mnia", "main"}, {"nitmain", "main"},
-        {"cot", "cout"}, {"ocout", "cout"}, {"cut", "cout"}, {"ct", "cout"}, {"out", "cout"},
-        {"cn", "cin"}, {"cinn", "cin"},
-        {"retrun", "return"}, {"reutrn", "return"}, {"retun", "return"},
-        {"vecotr", "vector"}, {"vcetor", "vector"},
-        {"iotream", "iostream"}, {"iostraem", "iostream"},
-        {"incldue", "include"}, {"inlcude", "include"}, {"inlude", "include"}, {"inclde", "include"},
-        {"fi", "if"}, {"fr", "for"}, {"fo", "for"}, {"whle", "while"},  // Short keyword typos
-        {"defin", "define"}, {"namspace", "namespace"}, {"it", "int"}, {"intz", "int"}  // More typos
-    };
+    // Check known typos first (fast)
+    auto typo = knownTypos.find(lowerWord);
+    if (typo != knownTypos.end()) {
+        const std::string &correction = typo->second;
+        issues.add(IssueCode::IDENTIFIER, columnOf(tokens, i), word, correction);
+        tokens[i].value = correction;
+        tokens[i].type = TokType::KEYWORD;
+        return 0;
+    }
     
-    for (size_t i = 0; i < tokens.size(); ++i){
-        // Special case: "using namespacestd" -> "using namespace std" (missing space)
-        if (tokens[i].type == TokType::KEYWORD && tokens[i].value == "using"){
-            // find next meaningful token
-            size_t j = i + 1;
-            while (j < tokens.size() && tokens[j].type == TokType::WHITESPACE) ++j;
-            if (j < tokens.size() && tokens[j].type == TokType::IDENTIFIER){
-                std::string lw = tokens[j].value; std::transform(lw.begin(), lw.end(), lw.begin(), [](unsigned char c){ return (char)std::tolower(c); });
-                if (lw == "namespacestd"){
-                    tokens[j].value = "namespace std"; // simple split in-place
-                    tokens[j].type = TokType::KEYWORD;   // treat as keyword chunk for now
-                    issues.push_back("identifier 'namespacestd' -> 'namespace std'");
+    // **MODERATE TRIE CHECK**: Check identifiers length >= 4
+    // Skip short words (2-3 chars) unless followed by '('
+    bool checkTrie = false;
+    
+    if (word.length() >= 4) {
+        checkTrie = true;  // Always check 4+ character words
+    } else if (word.length() >= 2 && word.length() <= 3) {
+        // For short words, only check if followed by '('
+        for (size_t j = i + 1; j < tokens.size(); ++j) {
+            if (tokens[j].type != TokType::WHITESPACE) {
+                if (tokens[j].type == TokType::SEPARATOR && tokens[j].value == "(") {
+                    checkTrie = true;
                 }
+                break;
             }
         }
-        // Skip tokens in comments and string literals ONLY
-        if (tokens[i].type == TokType::COMMENT || tokens[i].type == TokType::STRING_LITERAL) {
-            continue;
+    }
+    
+    // Names the file declares somewhere (two-pass mode) are the user's, not typos
+    if (checkTrie && harvest_ && fileIndex_.isDeclared(word)) checkTrie = false;
+
+    if (checkTrie) {
+        // Each distinct word is looked up in the trie once per run
+        const std::string *memoized = memo.find(word);
+        if (!memoized){
+            auto suggestions = trie_.getSuggestions(word, 2);
+            memoized = &memo.store(word, !suggestions.empty() && suggestions[0] != word ? suggestions[0] : std::string());
         }
-        
-        // Check ALL IDENTIFIER and KEYWORD tokens
-        if (tokens[i].type == TokType::IDENTIFIER || tokens[i].type == TokType::KEYWORD){
-            std::string word = tokens[i].value;
-            std::string lowerWord = word;
-            std::transform(lowerWord.begin(), lowerWord.end(), lowerWord.begin(), 
-                          [](unsigned char c){ return (char)std::tolower(c); });
-
-            // Heuristic split: type merged with identifier (e.g., "intx" -> "int x")
-            if (tokens[i].type == TokType::IDENTIFIER && lowerWord.rfind("int", 0) == 0 && word.size() > 3){
-                std::string suffix = word.substr(3);
-                // suffix must start with a valid identifier char
-                if (!suffix.empty() && (std::isalpha((unsigned char)suffix[0]) || suffix[0]=='_')){
-                    // Replace current token with 'int' keyword, insert space and suffix identifier
-                    tokens[i] = {TokType::KEYWORD, "int"};
-                    tokens.insert(tokens.begin() + i + 1, {TokType::WHITESPACE, " "});
-                    tokens.insert(tokens.begin() + i + 2, {TokType::IDENTIFIER, suffix});
-                    issues.push_back("split '" + word + "' -> 'int " + suffix + "'");
-                    // Advance past inserted tokens
-                    i += 2;
-                    // Continue to next token
-                    continue;
-                }
-            }
-            
-            // Check known typos first (fast)
-            if (knownTypos.count(lowerWord)) {
-                std::string correction = knownTypos.at(lowerWord);
-                issues.push_back("identifier '" + word + "' -> '" + correction + "'");
-                tokens[i].value = correction;
+        if (!memoized->empty()) {
+            std::string correction = *memoized;
+            issues.add(IssueCode::IDENTIFIER, columnOf(tokens, i), word, correction);
+            tokens[i].value = correction;
+            // Mark as KEYWORD if it's a C++ keyword
+            if (correction == "for" || correction == "if" || correction == "while" || 
+                correction == "return" || correction == "int" || correction == "void" ||
+                correction == "float" || correction == "double" || correction == "char" ||
+                correction == "include" || correction == "define" || correction == "namespace") {
                 tokens[i].type = TokType::KEYWORD;
-                continue;
-            }
-            
-            // **MODERATE TRIE CHECK**: Check identifiers length >= 4
-            // Skip short words (2-3 chars) unless followed by '('
-            bool checkTrie = false;
-            
-            if (word.length() >= 4) {
-                checkTrie = true;  // Always check 4+ character words
-            } else if (word.length() >= 2 && word.length() <= 3) {
-                // For short words, only check if followed by '('
-                for (size_t j = i + 1; j < tokens.size(); ++j) {
-                    if (tokens[j].type != TokType::WHITESPACE) {
-                        if (tokens[j].type == TokType::SEPARATOR && tokens[j].value == "(") {
-                            checkTrie = true;
-                        }
-                        break;
-                    }
-                }
-            }
-            
-            if (checkTrie) {
-                auto suggestions = trie_.getSuggestions(word, 2);
-                if (!suggestions.empty() && suggestions[0] != word) {
-                    std::string correction = suggestions[0];
-                    issues.push_back("identifier '" + word + "' -> '" + correction + "'");
-                    tokens[i].value = correction;
-                    // Mark as KEYWORD if it's a C++ keyword
-                    if (correction == "for" || correction == "if" || correction == "while" || 
-                        correction == "return" || correction == "int" || correction == "void" ||
-                        correction == "float" || correction == "double" || correction == "char" ||
-                        correction == "include" || correction == "define" || correction == "namespace") {
-                        tokens[i].type = TokType::KEYWORD;
-                    }
-                }
             }
-            // Short words like "ni", "x", "i" are left UNCHANGED (could be variables)
         }
     }
+    // Short words like "ni", "x", "i" are left UNCHANGED (could be variables)
+    return 0;
 }
 
 // Removed unused function: isControlStart (was defined but never called)
 
-void Analyzer::addMissingSemicolon(std::vector<Token> &tokens, std::vector<std::string> &issues){
+void Analyzer::addMissingSemicolon(TokenRewriter &tokens, IssueList &issues){
     if (tokens.empty()) return;
     
     // Step 1: Find first meaningful token (skip WHITESPACE)
@@ -639,8 +741,8 @@ void Analyzer::addMissingSemicolon(std::vector<Token> &tokens, std::vector<std::
     
     // Rule 2: COMMENT CHECK
     // Check if any token is a comment - EARLY EXIT
-    for (const auto &tk : tokens) {
-        if (tk.type == TokType::COMMENT) {
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        if (tokens[i].type == TokType::COMMENT) {
             return; // Early exit for any comment in the line
         }
     }
@@ -704,7 +806,7 @@ void Analyzer::addMissingSemicolon(std::vector<Token> &tokens, std::vector<std::
     
     // Rule 4: Add Semicolon - if we reach here, it's a statement that needs one
     tokens.push_back({TokType::SEPARATOR, ";"});
-    issues.push_back("added missing semicolon");
+    issues.add(IssueCode::MISSING_SEMICOLON, columnOf(tokens, tokens.size() - 1));
     
     // Default: don't add semicolon for other cases
 }
@@ -717,92 +819,482 @@ std::string Analyzer::applyIndentRule(const std::string &line){
     return ind + t;
 }
 
-void Analyzer::updateBraceState(const std::vector<Token> &tokens, std::vector<std::string> &issues){
-    for (const auto &tk : tokens){
-    if (tk.type!=TokType::SEPARATOR) continue;
-        const std::string &v = tk.value;
-        if (v=="{") { braceStack_.push_back('{'); ++indent_; }
-        else if (v=="}") { if (!braceStack_.empty() && braceStack_.back()=='{'){ braceStack_.pop_back(); indent_ = std::max(0, indent_-1); } else issues.push_back("unmatched '}' removed or extra"); }
-        else if (v=="(") { braceStack_.push_back('('); }
-        else if (v==")") { if (!braceStack_.empty() && braceStack_.back()=='('){ braceStack_.pop_back(); } else issues.push_back("unmatched ')' detected"); }
-        else if (v=="[") { braceStack_.push_back('['); }
-        else if (v=="]") { if (!braceStack_.empty() && braceStack_.back()=='['){ braceStack_.pop_back(); } else issues.push_back("unmatched ']' detected"); }
+bool Analyzer::indentMatches(const std::string &line) const {
+    size_t i = 0, j = line.size();
+    while (i<j && std::isspace((unsigned char)line[i])) ++i;
+    while (j>i && std::isspace((unsigned char)line[j-1])) --j;
+    if (j != line.size()) return false; // trailing whitespace is trimmed
+    int localIndent = indent_;
+    if (i < j && line[i]=='}') localIndent = std::max(0, indent_-1);
+    if (i != (size_t)localIndent*4) return false;
+    for (size_t k=0; k<i; ++k) if (line[k] != ' ') return false;
+    return true;
+}
+
+void Analyzer::updateBraceState(const std::string &brackets, IssueList &issues){
+    for (char v : brackets){
+        if (v=='{') { braceStack_.push_back('{'); ++indent_; }
+        else if (v=='}') { if (!braceStack_.empty() && braceStack_.back()=='{'){ braceStack_.pop_back(); indent_ = std::max(0, indent_-1); } else issues.add(IssueCode::UNMATCHED_BRACE); }
+        else if (v=='(') { braceStack_.push_back('('); }
+        else if (v==')') { if (!braceStack_.empty() && braceStack_.back()=='('){ braceStack_.pop_back(); } else issues.add(IssueCode::UNMATCHED_PAREN); }
+        else if (v=='[') { braceStack_.push_back('['); }
+        else if (v==']') { if (!braceStack_.empty() && braceStack_.back()=='['){ braceStack_.pop_back(); } else issues.add(IssueCode::UNMATCHED_BRACKET); }
     }
 }
 
-LineResult Analyzer::processLine(const std::string &line, size_t lineNo){
-    LineResult res; res.original = line; res.corrected = line; res.changed = false;
-    // Token-based pipeline:
-    // 1) Tokenize
-    auto tokens = tokenizer_.tokenize(line);
+// Declarations are recognized on the raw tokens, before any fix:
+//   <type keyword> [* &] name     int x, char *p, string s
+//   <type keyword><...> name      vector<int> v
+//   Name name  (then ; = , ( ) [ ] { or end of line)   MyType obj; floot avg;
+//   struct/class Name
+//   , name   after a declaration, at its parenthesis depth   int a = 1, b;
+// Every identifier not followed by '(' also gets a USE event so resolveScopes can flag it.
+void Analyzer::scanScopes(const TokenStream &ts, std::vector<ScopeEvent> &events) const {
+    events.clear();
+    if (!ts.summary.hasKind(TokType::IDENTIFIER) && !ts.summary.hasKind(TokType::SEPARATOR)) return;
+    const size_t none = (size_t)-1;
+    auto isKeyword = [&](size_t k, uint64_t mask){
+        return k != none && ts.kind(k) == TokType::KEYWORD && ts.keywordIds[k] >= 0 && (mask >> ts.keywordIds[k] & 1);
+    };
+    auto isOp = [&](size_t k, const char *op){ return k != none && ts.kind(k) == TokType::OPERATOR && ts.text(k) == op; };
 
-    // 2) Fix include directives first (adds missing #)
-    fixInclude(tokens, res.issues);
-    
-    // 3) Word/identifier corrections
-    fixCommonIdentifierTypos(tokens, res.issues);
-    fixIdentifiers(tokens, res.issues);
+    size_t prev = none, prev2 = none;
+    int paren = 0;
+    int declParen = -1;       // parenthesis depth of the declaration list we are in
+    bool listName = false;    // a ',' of that list was just seen
+    int angle = 0;            // open '<' of a template type
+    size_t templateEnd = none; // token that closed a template type
+    for (size_t i=ts.nextMeaningful(0); i<ts.size(); i=ts.nextMeaningful(i + 1)){
+        TokType k = ts.kind(i);
+        if (k == TokType::COMMENT) continue;
+        std::string_view t = ts.text(i);
+        if (angle > 0 && k == TokType::OPERATOR){
+            if (t == "<") ++angle;
+            else if (t == ">") --angle;
+            else if (t == ">>") angle -= 2;
+            if (angle <= 0){ angle = 0; templateEnd = i; }
+        } else if (k == TokType::OPERATOR && t == "<" && isKeyword(prev, typeKeywords_)){
+            angle = 1;
+        } else if (k == TokType::SEPARATOR){
+            char c = t[0];
+            if (c == '{'){ events.push_back({ScopeEvent::ENTER, (uint32_t)i}); declParen = -1; }
+            else if (c == '}'){ events.push_back({ScopeEvent::EXIT, (uint32_t)i}); declParen = -1; }
+            else if (c == '(') ++paren;
+            else if (c == ')'){ --paren; if (paren < declParen) declParen = -1; }
+            else if (c == ';') declParen = -1;
+            else if (c == ',') listName = (paren == declParen);
+        } else if (k == TokType::IDENTIFIER){
+            bool decl = listName || isKeyword(prev, typeKeywords_ | recordKeywords_) || (prev != none && prev == templateEnd);
+            if (!decl && (isOp(prev, "*") || isOp(prev, "&"))) decl = isKeyword(prev2, typeKeywords_);
+            if (!decl && prev != none && ts.kind(prev) == TokType::IDENTIFIER){
+                size_t next = ts.nextMeaningful(i + 1);
+                if (next >= ts.size() || ts.kind(next) == TokType::COMMENT) decl = true;
+                else {
+                    std::string_view n = ts.text(next);
+                    decl = (ts.kind(next) == TokType::SEPARATOR && n.find_first_of(";,()[]{") == 0 && n.size() == 1)
+                        || (ts.kind(next) == TokType::OPERATOR && n == "=");
+                }
+            }
+            // A name followed by '(' is a function or a call (or a mistyped 'for(' / 'if('):
+            // it is neither declared nor protected, and stays subject to dictionary correction
+            size_t next = ts.nextMeaningful(i + 1);
+            bool call = next < ts.size() && ts.kind(next) == TokType::SEPARATOR && ts.text(next) == "(";
+            if (decl && !call){
+                events.push_back({ScopeEvent::DECLARE, (uint32_t)i, ts.offsets[i], ts.lengths[i]});
+                declParen = paren;
+            }
+            if (decl && call) events.push_back({ScopeEvent::FUNCTION, (uint32_t)i, ts.offsets[i], ts.lengths[i]});
+            if (!call) events.push_back({ScopeEvent::USE, (uint32_t)i, ts.offsets[i], ts.lengths[i]});
+        }
+        if (!(k == TokType::SEPARATOR && t == ",")) listName = false;
+        prev2 = prev; prev = i;
+    }
+}
+
+void Analyzer::resolveScopes(const std::string &line, LineWork &work){
+    work.declared.clear();
+    for (const auto &ev : work.scopes){
+        switch (ev.kind){
+        case ScopeEvent::ENTER: sym_.enterScope(); break;
+        case ScopeEvent::EXIT: sym_.exitScope(); break;
+        case ScopeEvent::DECLARE:
+            sym_.declare(std::string_view(line).substr(ev.offset, ev.length));
+            break;
+        case ScopeEvent::USE:
+            if (sym_.isDeclared(std::string_view(line).substr(ev.offset, ev.length))) work.declared.push_back(ev.token);
+            break;
+        case ScopeEvent::FUNCTION: break;
+        }
+    }
+}
 
-    // 4) Operator & stream fixes (fixStreamOperators includes all operator fixes)
-    fixStreamOperators(tokens, res.issues);
-    fixInvalidCharLiterals(tokens, res.issues);
-    fixForLoop(tokens, res.issues);
+void Analyzer::analyzeLine(RuleContext &ctx, const std::string &line, LineWork &work, bool lexed, bool text){
+    work.issues.clear();
+    work.issues.bind(&ctx.names);
+    work.brackets.clear();
+    // Token-based pipeline:
+    // 1) Tokenize (into the reused scratch buffers); mark declared identifiers
+    if (!lexed) tokenizer_.tokenize(line, ctx.stream);
+    ctx.stream.toTokens(ctx.tokens);
+    for (uint32_t k : work.declared) ctx.tokens[k].flags |= TOKEN_DECLARED;
 
-    // 5) Pattern fixes (semicolons) - must be after fixInclude
-    addMissingSemicolon(tokens, res.issues);
+    // 2-5) Fix rules in pipeline order (include, words, operators/streams,
+    //      char literals, for-loops, semicolons); see registerRules
+    engine_.run(ctx, work.issues);
 
     // 6) Rebuild string from tokens
-    res.corrected = detokenize(tokens);
+    if (text) work.corrected = detokenize(ctx.tokens);
+
+    // Bracket separators, replayed against the brace stack by finishLine
+    if (ctx.stream.summary.hasKind(TokType::SEPARATOR)){
+        for (const auto &tk : ctx.tokens){
+            if (tk.type == TokType::SEPARATOR && tk.value.size() == 1 && strchr("{}()[]", tk.value[0])) work.brackets += tk.value[0];
+        }
+    }
+}
+
+LineResult Analyzer::finishLine(const std::string &line, LineWork &work, size_t lineNo){
+    LineResult res; res.original = line;
+    res.corrected = std::move(work.corrected);
+    IssueList &issues = work.issues;
 
     // 7) Indent rule (BEFORE updating brace state so we use the OLD indent level)
     std::string indented = applyIndentRule(res.corrected);
     if (indented != res.corrected){
-        res.issues.push_back("auto-indented");
+        issues.add(IssueCode::AUTO_INDENT);
         res.corrected = indented;
     }
 
     // 8) Update brace/paren state (AFTER indenting, for NEXT line)
-    updateBraceState(tokens, res.issues);
+    updateBraceState(work.brackets, issues);
 
     res.changed = (res.corrected != res.original);
 
-    // logging
-    if (!res.issues.empty()){
+    // Records from a worker context quote words interned there; re-intern them here
+    Interner &names = ctx_.names;
+    for (auto &issue : issues){
+        issue.line = (uint32_t)lineNo;
+        if (issues.names() != &names){
+            if (issue.a) issue.a = names.intern(issues.names()->str(issue.a));
+            if (issue.b) issue.b = names.intern(issues.names()->str(issue.b));
+        }
+    }
+
+    // Messages are only formatted for the sinks that want text
+    if (formatIssues_){
+        res.issues.reserve(issues.size());
+        for (auto &issue : issues) res.issues.push_back(::formatIssue(issue, names));
+    }
+    if (!issues.empty() && log_.isOpen()){
         std::ostringstream oss;
-        for (size_t i=0;i<res.issues.size();++i){
-            oss << " - " << res.issues[i] << "\n";
+        for (size_t i=0;i<issues.size();++i){
+            oss << " - " << (formatIssues_ ? res.issues[i] : ::formatIssue(issues[i], names)) << "\n";
         }
         if (res.changed) log_.fix(lineNo, res.original, res.corrected, "Applied corrections:\n" + oss.str());
         else log_.issue(lineNo, "Potential issues:\n" + oss.str());
     }
+    if (issueSink_) issueSink_->insert(issueSink_->end(), issues.begin(), issues.end());
+    res.records = std::move(issues.items());
+    issues.clear();
     return res;
 }
 
+LineResult Analyzer::processLine(const std::string &line, size_t lineNo){
+    tokenizer_.tokenize(line, ctx_.stream);
+    scanScopes(ctx_.stream, work_.scopes);
+    resolveScopes(line, work_);
+    analyzeLine(ctx_, line, work_, true);
+    return finishLine(line, work_, lineNo);
+}
+
+std::vector<std::string> Analyzer::passStats() const {
+    auto table = engine_.formatStats(ctx_.stats);
+    const CorrectionMemo &m = ctx_.memo;
+    char buf[128];
+    snprintf(buf, sizeof buf, "correction memo: %llu/%llu hits (%.1f%%)", (unsigned long long)m.hits,
+             (unsigned long long)m.lookups, m.lookups ? 100.0 * m.hits / m.lookups : 0.0);
+    table.push_back(buf);
+    return table;
+}
+
+void Analyzer::resetPassStats(){
+    ctx_.stats.clear();
+    ctx_.memo.hits = ctx_.memo.lookups = 0;
+}
+
+bool Analyzer::configurePasses(const std::string &spec, std::string *error){
+    return engine_.configure(spec, error);
+}
+
 std::vector<std::string> Analyzer::processFile(const std::vector<std::string> &lines, std::vector<std::string> &fileIssues){
     std::vector<std::string> out;
-    braceStack_.clear(); indent_ = 0;
-    size_t ln=1;
-    for (auto &l : lines){
-        auto r = processLine(l, ln++);
-        out.push_back(r.corrected);
+    out.reserve(lines.size());
+    resetFileState();
+    unsigned workers = threads_ ? threads_ : std::max(1u, std::thread::hardware_concurrency());
+    if (harvest_) harvestDeclarations(lines, lines.size() >= kParallelMinLines ? workers : 1);
+    if (workers > 1 && lines.size() >= kParallelMinLines){
+        processLinesParallel(lines, out, workers);
+    } else {
+        size_t ln=1;
+        for (auto &l : lines){
+            auto r = processLine(l, ln++);
+            out.push_back(r.corrected);
+        }
     }
     finalizeFile(out, fileIssues);
+    logPassStats();
     return out;
 }
 
+static std::function<bool(std::string &)> getlineFrom(std::istream &in){
+    return [&in](std::string &line){ return bool(std::getline(in, line)); };
+}
+
+size_t Analyzer::processStream(std::istream &in, std::ostream &out, std::vector<std::string> &fileIssues){
+    return streamLines(getlineFrom(in), nullptr, fileIssues, [&out](const std::string *, const std::string &fixed){ out << fixed << '\n'; });
+}
+
+size_t Analyzer::processStream(std::istream &in, DiffWriter &diff, std::vector<std::string> &fileIssues){
+    // getline only hits end of file on a line with no newline after it
+    bool noNewline = false;
+    auto next = [&in, &noNewline](std::string &line){
+        if (!std::getline(in, line)) return false;
+        noNewline = in.eof();
+        return true;
+    };
+    size_t n = streamLines(next, nullptr, fileIssues, [&diff](const std::string *original, const std::string &fixed){
+        if (original) diff.line(*original, fixed);
+        else diff.added(fixed);
+    });
+    diff.setNoNewlineAtEnd(noNewline);
+    diff.finish();
+    return n;
+}
+
+size_t Analyzer::processStream(const std::function<bool(std::string &)> &next, const std::function<bool()> &ready,
+                               const std::function<void(const std::string &)> &emit, std::vector<std::string> &fileIssues){
+    return streamLines(next, ready, fileIssues, [&emit](const std::string *, const std::string &fixed){ emit(fixed); });
+}
+
+size_t Analyzer::streamLines(const std::function<bool(std::string &)> &next, const std::function<bool()> &ready,
+                             std::vector<std::string> &fileIssues,
+                             const std::function<void(const std::string *, const std::string &)> &emit){
+    resetFileState();
+    unsigned workers = threads_ ? threads_ : std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::string> block, fixed;
+    block.reserve(kStreamBlockLines);
+    size_t lineNo = 1;
+    bool more = true;
+    while (more){
+        // Refill the block, reusing its strings' buffers
+        size_t n = 0;
+        while (n < kStreamBlockLines){
+            if (n > 0 && ready && !ready()) break;
+            if (n == block.size()) block.emplace_back();
+            if (!next(block[n])){ more = false; break; }
+            ++n;
+        }
+        block.resize(n);
+        if (n == 0) break;
+
+        fixed.clear();
+        if (workers > 1 && n >= kParallelMinLines){
+            processLinesParallel(block, fixed, workers, lineNo);
+        } else {
+            for (size_t i=0; i<n; ++i) fixed.push_back(processLine(block[i], lineNo + i).corrected);
+        }
+        for (size_t i=0; i<n; ++i) emit(&block[i], fixed[i]);
+        lineNo += n;
+    }
+
+    // Only the missing-'}' tail depends on end-of-input state
+    std::vector<std::string> tail;
+    finalizeFile(tail, fileIssues);
+    for (auto &l : tail) emit(nullptr, l);
+    logPassStats();
+    return lineNo - 1;
+}
+
+void Analyzer::resetFileState(){
+    braceStack_.clear(); indent_ = 0;
+    sym_.clear();
+    fileIndex_.clear();
+    // Records of the previous file have been consumed; a long-lived Analyzer
+    // would otherwise keep every word any issue ever quoted
+    ctx_.names.clear();
+    for (auto &ctx : workerCtx_) ctx->names.clear();
+}
+
+void Analyzer::forEachLine(size_t n, unsigned workers, const std::function<void(unsigned, size_t)> &perLine){
+    workers = (unsigned)std::max<size_t>(1, std::min<size_t>(workers, n));
+    if (workers == 1){
+        for (size_t i=0; i<n; ++i) perLine(0, i);
+        return;
+    }
+    const size_t chunk = (n + workers - 1) / workers;
+    std::vector<std::thread> pool;
+    for (unsigned w=0; w<workers; ++w){
+        size_t begin = w * chunk, end = std::min(n, begin + chunk);
+        if (begin >= end) break;
+        pool.emplace_back([&perLine, w, begin, end]{
+            for (size_t i=begin; i<end; ++i) perLine(w, i);
+        });
+    }
+    for (auto &t : pool) t.join();
+}
+
+// First pass of two-pass mode: the declarations of each line are found by the same
+// raw-token scan the scope replay uses, so every worker can work on its own chunk;
+// the names are merged afterwards. Scopes are ignored: a name declared anywhere in
+// the file is known.
+void Analyzer::harvestDeclarations(const std::vector<std::string> &lines, unsigned workers){
+    workers = (unsigned)std::max<size_t>(1, std::min<size_t>(workers, lines.size()));
+    while (workerCtx_.size() < workers) workerCtx_.push_back(std::make_unique<RuleContext>());
+    struct Harvest {
+        std::vector<ScopeEvent> events;
+        std::vector<std::string_view> names;
+    };
+    std::vector<Harvest> found(workers);
+    forEachLine(lines.size(), workers, [&](unsigned w, size_t i){
+        Harvest &h = found[w];
+        tokenizer_.tokenize(lines[i], workerCtx_[w]->stream);
+        scanScopes(workerCtx_[w]->stream, h.events);
+        for (const auto &ev : h.events){
+            if (ev.kind == ScopeEvent::DECLARE || ev.kind == ScopeEvent::FUNCTION){
+                h.names.push_back(std::string_view(lines[i]).substr(ev.offset, ev.length));
+            }
+        }
+    });
+    for (const auto &h : found){
+        for (auto name : h.names) fileIndex_.declare(name);
+    }
+}
+
+Analyzer::LineState Analyzer::lineState() const {
+    return {indent_, braceStack_, sym_.fingerprint()};
+}
+
+void Analyzer::restoreLineState(const LineState &state, const SymbolTable *symbols){
+    indent_ = state.indent;
+    braceStack_ = state.braces;
+    if (symbols) sym_ = *symbols;
+}
+
+void Analyzer::replayScopes(const std::string &line){
+    tokenizer_.tokenize(line, ctx_.stream);
+    scanScopes(ctx_.stream, work_.scopes);
+    resolveScopes(line, work_);
+}
+
+void Analyzer::logPassStats(){
+    if (!dumpPassStats_) return;
+    std::vector<std::string> report{"Pass statistics:"};
+    for (auto &row : passStats()) report.push_back("  " + row);
+    log_.writeAnalysis(report);
+}
+
+// Parallel file pass: the fix rules only look at the line being fixed (plus which of
+// its identifiers are declared, resolved beforehand by a short sequential replay of
+// scope events), so chunks of lines are analyzed on worker threads (each with its
+// own RuleContext). Indentation and brace checks need the brace stack as of the
+// previous line; that stack follows
+// matched-pair rules (a '}' does not pop a '('), so it is not a plain prefix sum of
+// per-chunk deltas. Instead each worker records the bracket separators per line and
+// the sequential fix-up replays them, which costs O(brackets) rather than a re-lex.
+void Analyzer::processLinesParallel(const std::vector<std::string> &lines, std::vector<std::string> &out, unsigned workers, size_t firstLineNo){
+    const size_t n = lines.size();
+    workers = (unsigned)std::min<size_t>(workers, n);
+    std::vector<LineWork> work(n);
+    while (workerCtx_.size() < workers) workerCtx_.push_back(std::make_unique<RuleContext>());
+
+    // 1) Scope events per line (parallel), 2) replay them against the symbol table
+    //    in line order, 3) fix rules with the declared flags (parallel)
+    forEachLine(n, workers, [&](unsigned w, size_t i){
+        tokenizer_.tokenize(lines[i], workerCtx_[w]->stream);
+        scanScopes(workerCtx_[w]->stream, work[i].scopes);
+    });
+    for (size_t i=0; i<n; ++i) resolveScopes(lines[i], work[i]);
+    forEachLine(n, workers, [&](unsigned w, size_t i){ analyzeLine(*workerCtx_[w], lines[i], work[i]); });
+
+    // Fold the workers' pass and memo counters into this analyzer's stats
+    if (ctx_.stats.size() < engine_.rules().size()) ctx_.stats.resize(engine_.rules().size());
+    for (auto &c : workerCtx_){
+        for (size_t r=0; r<c->stats.size() && r<ctx_.stats.size(); ++r) ctx_.stats[r] += c->stats[r];
+        c->stats.clear();
+        ctx_.memo.hits += c->memo.hits;
+        ctx_.memo.lookups += c->memo.lookups;
+        c->memo.hits = c->memo.lookups = 0;
+    }
+
+    // Sequential fix-up: indentation, brace checks and logging in line order
+    for (size_t i=0; i<n; ++i){
+        out.push_back(finishLine(lines[i], work[i], firstLineNo + i).corrected);
+    }
+}
+
+size_t Analyzer::checkFile(const std::vector<std::string> &lines, size_t maxIssues, std::vector<Issue> *records){
+    resetFileState();
+    // Judge the file as processFile would fix it
+    if (harvest_) harvestDeclarations(lines, 1);
+    size_t found = 0;
+    auto take = [&](const Issue &issue){
+        if (found >= maxIssues) return;
+        ++found;
+        if (records) records->push_back(issue);
+    };
+    for (size_t i=0; i<lines.size() && found < maxIssues; ++i){
+        const std::string &line = lines[i];
+        tokenizer_.tokenize(line, ctx_.stream);
+        scanScopes(ctx_.stream, work_.scopes);
+        resolveScopes(line, work_);
+        analyzeLine(ctx_, line, work_, true, false);
+        // The rules report every change they make and keep leading whitespace, so
+        // the indentation rule is judged on the original line
+        if (!indentMatches(line)) work_.issues.add(IssueCode::AUTO_INDENT);
+        updateBraceState(work_.brackets, work_.issues);
+        for (auto issue : work_.issues){
+            issue.line = (uint32_t)(i + 1);
+            take(issue);
+        }
+    }
+    if (found < maxIssues && !braceStack_.empty()){
+        std::vector<std::string> tail;
+        std::vector<Issue> eof;
+        finalizeFile(tail, eof);
+        for (auto &issue : eof) take(issue);
+    }
+    return found;
+}
+
 void Analyzer::finalizeFile(std::vector<std::string> &corrected, std::vector<std::string> &fileIssues){
+    std::vector<Issue> records;
+    finalizeFile(corrected, records);
+    // Without formatting, a sink takes the records and no text is built
+    if (!formatIssues_ && issueSink_){
+        issueSink_->insert(issueSink_->end(), records.begin(), records.end());
+        return;
+    }
+    for (auto &issue : records) fileIssues.push_back(formatIssue(issue));
+}
+
+void Analyzer::finalizeFile(std::vector<std::string> &corrected, std::vector<Issue> &records){
     // Only auto-insert missing '}' to preserve structure; for other unmatched symbols, log issues
+    auto report = [&](IssueCode code){
+        Issue issue;
+        issue.code = code;
+        records.push_back(issue);
+    };
     while (!braceStack_.empty()){
         char top = braceStack_.back();
         braceStack_.pop_back();
         if (top == '{'){
             corrected.push_back(std::string(std::max(0, indent_-1)*4, ' ') + "}");
             if (indent_>0) --indent_;
-            fileIssues.push_back("inserted missing closing '}' at end of file");
+            report(IssueCode::EOF_BRACE_INSERTED);
         } else if (top == '('){
-            fileIssues.push_back("missing ')' at end of file");
+            report(IssueCode::EOF_MISSING_PAREN);
         } else if (top == '['){
-            fileIssues.push_back("missing ']' at end of file");
+            report(IssueCode::EOF_MISSING_BRACKET);
         }
     }
 }
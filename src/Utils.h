@@ -1,18 +1,26 @@
 #pragma once
 #include <string>
+#include <iosfwd>
+#include <functional>
 #include <vector>
 #include <stack>
+#include <memory>
 #include <unordered_map>
 #include "Trie.h"
 #include "SymbolTable.h"
 #include "Logger.h"
 #include "Autocorrect.h"
 #include "Tokenizer.h"
+#include "TokenStream.h"
+#include "RuleEngine.h"
+#include "Issue.h"
+#include "DiffWriter.h"
 
 struct LineResult {
     std::string original;
     std::string corrected;
-    std::vector<std::string> issues;
+    std::vector<std::string> issues; // formatted records (empty when formatting is off)
+    std::vector<Issue> records;      // word ids refer to the Analyzer's issueNames(), until the next file
     bool changed = false;
 };
 
@@ -26,41 +34,185 @@ public:
     // Process an entire file worth of lines; returns corrected lines
     std::vector<std::string> processFile(const std::vector<std::string> &lines, std::vector<std::string> &fileIssues);
 
-    // Close any remaining braces at EOF
+    // Streaming variant of processFile: reads lines from in and writes corrected lines
+    // to out as it goes, holding at most kStreamBlockLines lines in memory. Output and
+    // fileIssues are identical to processFile. Returns the number of input lines.
+    size_t processStream(std::istream &in, std::ostream &out, std::vector<std::string> &fileIssues);
+    // Same, but only the changes are written, as a unified diff
+    size_t processStream(std::istream &in, DiffWriter &diff, std::vector<std::string> &fileIssues);
+    // Same, pulling lines from next() (false = end of input) and handing each fixed
+    // line to emit(). For input that arrives over time, such as a pipe, a block also
+    // ends as soon as ready() says the next line is not there yet, so no output waits
+    // on input it does not depend on.
+    size_t processStream(const std::function<bool(std::string &)> &next, const std::function<bool()> &ready,
+                         const std::function<void(const std::string &)> &emit, std::vector<std::string> &fileIssues);
+    static const size_t kStreamBlockLines = 16384;
+
+    // Sequential state carried from one line to the next. Together with the line
+    // text it fully determines processLine's result, so it serves as a checkpoint
+    // for incremental reprocessing (see IncrementalSession).
+    struct LineState {
+        int indent = 0;
+        std::vector<char> braces;
+        uint64_t symbols = 0; // SymbolTable::fingerprint()
+        bool operator==(const LineState &o) const { return indent == o.indent && symbols == o.symbols && braces == o.braces; }
+        bool operator!=(const LineState &o) const { return !(*this == o); }
+    };
+    LineState lineState() const;
+    // Continue from a captured state; symbols (if given) must be the table as it was
+    // then, otherwise the current table is kept
+    void restoreLineState(const LineState &state, const SymbolTable *symbols = nullptr);
+    const SymbolTable &symbols() const { return sym_; }
+    // Track a line's scopes and declarations without fixing it
+    void replayScopes(const std::string &line);
+    // Forget brace, indent and symbol state (start of a file). Also clears
+    // issueNames(): format the previous file's records before calling this.
+    void resetFileState();
+
+    // Check mode: would any fix apply? Runs the fix rules and brace checks but
+    // builds no corrected text (no detokenize, no indentation rewrite) and logs
+    // nothing; stops as soon as maxIssues issues are found. Returns the number
+    // found (at most maxIssues); records, if given, receive them, with line 0 for
+    // end-of-file bracket issues. A file has issues exactly when processFile would
+    // change it or report something; the counts can differ slightly.
+    size_t checkFile(const std::vector<std::string> &lines, size_t maxIssues = 1, std::vector<Issue> *records = nullptr);
+
+    // Close any remaining braces at EOF. The end-of-file issues are appended to
+    // fileIssues as text, or, with formatting off and an issue sink set, to the
+    // sink as records with line 0.
     void finalizeFile(std::vector<std::string> &corrected, std::vector<std::string> &fileIssues);
+    // The same, always as records (line 0)
+    void finalizeFile(std::vector<std::string> &corrected, std::vector<Issue> &records);
 
     // Get warnings about unclosed brackets (for pre-save/pre-quit checks)
     std::vector<std::string> getUnclosedBrackets() const;
 
     static int editDistance(const std::string &a, const std::string &b);
 
+    // Fix pass configuration, e.g. "fixForLoop=off,fixIdentifiers=on" or "-fixForLoop"
+    bool configurePasses(const std::string &spec, std::string *error = nullptr);
+    void setPassTiming(bool on) { engine_.setTiming(on); }
+
+    // Identifies what the fix rules produce, for caches of their output: a rules
+    // version plus the build time of the rule code (see registerRules)
+    static std::string rulesVersion();
+
+    // Per-pass lines/tokens examined/fixes/time (time only while pass timing is
+    // on), plus the correction memo hit rate, accumulated since the last reset
+    std::vector<std::string> passStats() const;
+    void resetPassStats();
+
+    // Write passStats() to the analysis log at the end of every processFile;
+    // turns pass timing on so the table has times in it
+    void setDumpPassStats(bool on) { dumpPassStats_ = on; if (on) setPassTiming(true); }
+
+    // Worker threads for processFile (0 = one per hardware thread). Files shorter
+    // than kParallelMinLines are processed serially; output is identical either way.
+    void setThreads(unsigned n) { threads_ = n; }
+    static const size_t kParallelMinLines = 4096;
+
+    // Two-pass processFile: first collect every name the file declares (variables,
+    // struct/class and function names, in any scope) on the worker threads, then
+    // keep those names away from the dictionary suggestions (off by default)
+    void setHarvestDeclarations(bool on) { harvest_ = on; }
+
+    // Also append every per-line issue record to sink (nullptr = off); used where
+    // the Logger is not the consumer, e.g. batch reports. With formatting off the
+    // end-of-file issues go there too (line 0) instead of into fileIssues.
+    void setIssueSink(std::vector<Issue> *sink) { issueSink_ = sink; }
+
+    // Fill LineResult::issues with formatted messages (on by default). With it off,
+    // and no open Logger, issues are only recorded, never formatted.
+    void setFormatIssues(bool on) { formatIssues_ = on; }
+    const Interner &issueNames() const { return ctx_.names; }
+    std::string formatIssue(const Issue &issue) const { return ::formatIssue(issue, ctx_.names); }
+
 private:
     Trie &trie_;
     SymbolTable &sym_;
     Logger &log_;
     Autocorrect autocorrect_;
     Tokenizer tokenizer_;
+    RuleEngine engine_; // fix passes, in pipeline order
+    RuleContext ctx_;   // per-line scratch (tokens, stream, issue buckets) reused across lines
+    std::vector<std::unique_ptr<RuleContext>> workerCtx_; // parallel path; kept so memos persist
 
     std::vector<char> braceStack_;
     int indent_ = 0;
+    bool dumpPassStats_ = false;
+    unsigned threads_ = 0;
+    std::vector<Issue> *issueSink_ = nullptr;
+    bool formatIssues_ = true;
+    bool harvest_ = false;
+    SymbolTable fileIndex_; // names declared anywhere in the file (harvest_ only)
+
+    // Scope-relevant facts of one line, taken from its raw tokens: braces,
+    // declarations and identifier uses, in token order
+    struct ScopeEvent {
+        enum Kind : uint8_t { ENTER, EXIT, DECLARE, USE, FUNCTION } kind; // FUNCTION: file index only
+        uint32_t token = 0;              // index in the raw token stream
+        uint32_t offset = 0, length = 0; // identifier text in the line
+    };
+
+    // Output of the stateless half of processLine: depends only on the line text
+    // (and, via `declared`, on the sequential scope replay), so it can be computed
+    // for many lines in parallel
+    struct LineWork {
+        std::vector<ScopeEvent> scopes;  // from scanScopes
+        std::vector<uint32_t> declared;  // raw token indices naming declared symbols
+        std::string corrected;           // after the fix rules, before indentation
+        IssueList issues;
+        std::string brackets;            // bracket separators in token order
+    };
+    LineWork work_;
+    uint64_t typeKeywords_ = 0;   // keyword ids that start a declaration
+    uint64_t recordKeywords_ = 0; // struct/class: the next identifier is declared
+
+    // Declaration/brace events of a tokenized line (stateless)
+    void scanScopes(const TokenStream &ts, std::vector<ScopeEvent> &events) const;
+    // Replay a line's events against sym_ and fill work.declared (sequential)
+    void resolveScopes(const std::string &line, LineWork &work);
+    // Tokenize + fix rules + detokenize (touches only ctx and work); `lexed` means
+    // ctx.stream already holds this line; without `text` only the issues and brackets are produced
+    void analyzeLine(RuleContext &ctx, const std::string &line, LineWork &work, bool lexed = false, bool text = true);
+    // Indentation, brace state and logging (sequential; uses indent_/braceStack_)
+    LineResult finishLine(const std::string &line, LineWork &work, size_t lineNo);
+    void processLinesParallel(const std::vector<std::string> &lines, std::vector<std::string> &out, unsigned workers, size_t firstLineNo = 1);
+    // Run perLine(worker, i) for i in [0, n) on contiguous chunks, one thread per worker
+    void forEachLine(size_t n, unsigned workers, const std::function<void(unsigned, size_t)> &perLine);
+    // Fill fileIndex_ from the declarations of every line
+    void harvestDeclarations(const std::vector<std::string> &lines, unsigned workers);
+    void logPassStats();
+    // processStream body: emit(original, fixed) per line in order; original is
+    // nullptr for lines appended at end of file. A null ready means always ready.
+    size_t streamLines(const std::function<bool(std::string &)> &next, const std::function<bool()> &ready,
+                       std::vector<std::string> &fileIssues,
+                       const std::function<void(const std::string *, const std::string &)> &emit);
 
     void seedDictionary();
+    // Any change to what the rules produce must change rulesVersion(); rebuilding
+    // Utils.cpp does, a rule change elsewhere (Tokenizer, RuleEngine) bumps kRulesVersion
+    void registerRules();
 
     std::string trim(const std::string &s);
 
     // Token-based fix functions (operate on token streams)
-    void fixInclude(std::vector<Token> &tokens, std::vector<std::string> &issues);
-    void fixForLoop(std::vector<Token> &tokens, std::vector<std::string> &issues);
+    // Line rules see the whole line; the *At rules handle token i and return how
+    // many tokens they inserted after it (see RuleEngine)
+    void fixInclude(TokenRewriter &tokens, IssueList &issues);
+    void fixForLoop(TokenRewriter &tokens, IssueList &issues);
     // Normalize common stream operator and identifier typos before suggestions
-    void fixStreamOperators(std::vector<Token> &tokens, std::vector<std::string> &issues);
-    void fixInvalidCharLiterals(std::vector<Token> &tokens, std::vector<std::string> &issues);
-    void fixCommonIdentifierTypos(std::vector<Token> &tokens, std::vector<std::string> &issues);
-    void fixIdentifiers(std::vector<Token> &tokens, std::vector<std::string> &issues);
-    void addMissingSemicolon(std::vector<Token> &tokens, std::vector<std::string> &issues);
+    size_t fixStreamOperatorsAt(TokenRewriter &tokens, size_t i, IssueList &issues);
+    size_t fixInvalidCharLiteralAt(TokenRewriter &tokens, size_t i, IssueList &issues);
+    size_t fixCommonIdentifierTypoAt(TokenRewriter &tokens, size_t i, IssueList &issues);
+    size_t fixIdentifierAt(TokenRewriter &tokens, size_t i, IssueList &issues, CorrectionMemo &memo);
+    void addMissingSemicolon(TokenRewriter &tokens, IssueList &issues);
     std::string applyIndentRule(const std::string &line);
+    // applyIndentRule(line) == line, without building the string
+    bool indentMatches(const std::string &line) const;
 
-    // Update brace/paren state from tokens only
-    void updateBraceState(const std::vector<Token> &tokens, std::vector<std::string> &issues);
+    // Update brace/paren state from a line's bracket separators
+    void updateBraceState(const std::string &brackets, IssueList &issues);
 
     // Convert tokens back to a single line string
     std::string detokenize(const std::vector<Token> &tokens) const;
@@ -1,3 +1,4 @@
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -13,6 +14,9 @@
 #include "SymbolTable.h"
 #include "Utils.h"
 #include "Logger.h"
+#include "Batch.h"
+#include "Cli.h"
+#include "DiffWriter.h"
 
 using namespace std;
 
@@ -26,12 +30,12 @@ static void openAnalysisWindow(const std::string &analysisPath){
 #endif
 }
 
-static vector<string> readAllLines(const string &path){
-    ifstream in(path);
-    vector<string> lines;
-    string s;
-    while (std::getline(in, s)) lines.push_back(s);
-    return lines;
+// Full corrected copies (default) or only a unified diff of the changes
+static bool askDiffOutput(){
+    cout << "Output: [f]ull corrected files or [d]iff only? (default f): ";
+    string ans;
+    std::getline(cin, ans);
+    return !ans.empty() && (ans[0] == 'd' || ans[0] == 'D');
 }
 
 static bool writeAllLines(const string &path, const vector<string> &lines){
@@ -41,16 +45,33 @@ static bool writeAllLines(const string &path, const vector<string> &lines){
     return true;
 }
 
-int main(){
+int main(int argc, char **argv){
     namespace fs = std::filesystem;
+    // Any argument selects the non-interactive driver (see Cli.h)
+    CliOptions opts;
+    if (argc > 1){
+        string error;
+        if (!parseCliArgs(vector<string>(argv + 1, argv + argc), opts, error)){
+            cerr << "intellifix: " << error << "\n\n" << cliUsage();
+            return 2;
+        }
+        if (opts.help){ cout << cliUsage(); return 0; }
+        if (opts.lsp) return runLsp(opts, 0, 1, cerr);
+        if (!opts.serveSocket.empty()) return runServe(opts, cerr);
+        if (!opts.connectSocket.empty()) return runClient(opts, cout, cerr);
+        if (opts.filter) return runFilter(opts, 0, 1, opts.issuesFd);
+        if (!opts.interactive) return runCli(opts, cout, cerr);
+    }
 
     cout << "IntelliFix++ — C++ autocorrect and suggestions" << endl;
     cout << "-------------------------------------------" << endl;
 
     // Prepare core services
     Trie trie; SymbolTable sym; Logger logger;
-    std::string outDir = (fs::path("c:/Users/iComputers/Documents/IntelliFixPP/output")).string();
+    std::string outDir = opts.logDir.empty() ? defaultLogDir() : opts.logDir;
     logger.init(outDir);
+    // Log writes happen on a background thread; flush() below only wakes it
+    logger.startAsync();
     Analyzer analyzer(trie, sym, logger);
 
     // Launch a persistent analysis/log window once
@@ -60,6 +81,7 @@ int main(){
         cout << "\nSelect mode:\n";
         cout << "  1) Interactive (line-by-line)\n";
         cout << "  2) File upload / batch fix\n";
+        cout << "  3) Multi-file batch fix (files and/or directories)\n";
         cout << "  0) Exit\n> ";
         string choice; if (!std::getline(cin, choice)) break;
         if (choice == "0") break;
@@ -277,9 +299,41 @@ int main(){
                 cout << "File not found: " << path << endl;
                 continue;
             }
-            auto lines = readAllLines(path);
+            if (!fs::is_regular_file(path)){
+                cout << "Not a regular file: " << path << endl;
+                continue;
+            }
+            // Open the input before creating (or truncating) the output
+            ifstream in(path);
+            if (!in.is_open()){
+                cout << "Failed to read input file: " << path << endl;
+                continue;
+            }
+            bool diffOnly = askDiffOutput();
+            // Prepare output path
+            fs::path inPath(path);
+            string outName = "corrected_" + inPath.filename().string() + (diffOnly ? ".diff" : "");
+            fs::path outPath = inPath.parent_path() / outName;
+
+            // Stream input to output so large files are never held in memory
+            ofstream out(outPath);
+            if (!out.is_open()){
+                cout << "Failed to write corrected file: " << outPath.string() << endl;
+                continue;
+            }
             vector<string> fileIssues;
-            auto fixed = analyzer.processFile(lines, fileIssues);
+            if (diffOnly){
+                DiffWriter diff(out, path, path);
+                analyzer.processStream(in, diff, fileIssues);
+                if (!diff.hunks()) cout << "\n[i] No changes." << endl;
+            } else {
+                analyzer.processStream(in, out, fileIssues);
+            }
+            out.close();
+            if (in.bad()){
+                cout << "Failed to read input file: " << path << " (" << outPath.string() << " is incomplete)" << endl;
+                continue;
+            }
 
             // Display file issues including bracket warnings
             if (!fileIssues.empty()){
@@ -294,13 +348,8 @@ int main(){
                 }
             }
 
-            // Prepare output path
-            fs::path inPath(path);
-            string outName = "corrected_" + inPath.filename().string();
-            fs::path outPath = inPath.parent_path() / outName;
-
-            if (writeAllLines(outPath.string(), fixed)){
-                cout << "\n[+] Wrote corrected file: " << outPath.string() << endl;
+            if (out){
+                cout << "\n[+] Wrote " << (diffOnly ? "diff: " : "corrected file: ") << outPath.string() << endl;
             } else {
                 cout << "Failed to write corrected file: " << outPath.string() << endl;
             }
@@ -312,6 +361,47 @@ int main(){
             logger.flush();
 
             cout << "Fix log: " << logger.fixesPath() << endl;
+        } else if (choice == "3"){
+            cout << "Enter files or directories (one per line, empty line to start):" << endl;
+            vector<string> inputs;
+            string p;
+            while (std::getline(cin, p) && !p.empty()) inputs.push_back(p);
+            vector<string> errors;
+            auto files = BatchRunner::collect(inputs, &errors);
+            for (auto &e : errors) cout << "  [-] " << e << endl;
+            if (files.empty()){
+                cout << "No source files found." << endl;
+                continue;
+            }
+
+            bool diffOnly = askDiffOutput();
+            cout << "Fixing " << files.size() << " file(s)..." << endl;
+            BatchRunner batch(trie);
+            batch.setDiffOutput(diffOnly);
+            batch.setCacheDir((fs::path(outDir) / "cache").string());
+            auto results = batch.run(files);
+            auto report = BatchRunner::formatReport(results);
+            report.push_back(batch.cache()->stats());
+
+            size_t failed = 0;
+            for (auto &r : results){
+                if (!r.ok){ ++failed; cout << "  [-] " << r.input << ": " << r.error << endl; }
+            }
+            cout << "\n[+] " << report.front() << endl;
+            if (failed) cout << "  " << failed << " file(s) failed" << endl;
+            cout << "  " << batch.cache()->stats() << endl;
+
+            if (diffOnly){
+                fs::path patchPath = fs::path(outDir) / "batch.patch";
+                ofstream patch(patchPath);
+                BatchRunner::writePatch(patch, results);
+                if (patch) cout << "Patch: " << patchPath.string() << " (apply with patch -p0)" << endl;
+            }
+
+            fs::path reportPath = fs::path(outDir) / "batch_report.txt";
+            if (writeAllLines(reportPath.string(), report)) cout << "Report: " << reportPath.string() << endl;
+            logger.writeAnalysis(report);
+            logger.flush();
         } else {
             cout << "Unknown choice: " << choice << endl;
         }
@@ -0,0 +1,117 @@
+// Analyzer long-line benchmark (regression check for token rewriting cost)
+//
+// Build (from repo root):
+//   g++ -std=c++17 -O2 -pthread -I src tests/bench_analyzer.cpp $(ls src/*.cpp | grep -v main.cpp) -o bench_analyzer
+//
+// Usage:
+//   bench_analyzer [--max-tokens N] [--repeat R] [--json [file]]
+//
+// Runs processLine on machine-generated lines of growing length whose passes
+// insert tokens all along the line ("intx" splits, for(...) semicolons). With
+// linear rewriting ns/token stays flat as the line grows; a quadratic rewrite
+// shows up as ns/token doubling with every doubling of the line.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Trie.h"
+#include "SymbolTable.h"
+#include "Utils.h"
+#include "Logger.h"
+
+using namespace std;
+
+struct Result {
+    string shape;
+    size_t tokens = 0;
+    double msPerLine = 0;
+    double nsPerToken = 0;
+};
+
+// Repeat `unit` until the line has at least `tokens` tokens
+static string makeLine(const string &unit, size_t tokens, const Tokenizer &tk){
+    size_t per = tk.tokenize(unit).size();
+    string line;
+    for (size_t n=0; n<tokens; n += per) line += unit;
+    return line;
+}
+
+int main(int argc, char **argv){
+    size_t maxTokens = 16000;
+    int repeat = 3;
+    bool json = false;
+    string jsonPath;
+    for (int i=1; i<argc; ++i){
+        string a = argv[i];
+        if (a == "--max-tokens" && i+1 < argc) maxTokens = std::strtoull(argv[++i], nullptr, 10);
+        else if (a == "--repeat" && i+1 < argc) repeat = std::max(1, atoi(argv[++i]));
+        else if (a == "--json"){
+            json = true;
+            if (i+1 < argc && argv[i+1][0] != '-') jsonPath = argv[++i];
+        }
+        else if (a == "--help" || a == "-h"){
+            cout << "usage: bench_analyzer [--max-tokens N] [--repeat R] [--json [file]]\n";
+            return 0;
+        }
+    }
+
+    const vector<pair<string, string>> shapes = {
+        {"intx splits", "intx=1;"},
+        {"for semicolons", "for(i=0 i<n i++) "},
+        {"mixed", "cot< y; intab=2; for(j=0, j<m, j++) "},
+    };
+
+    Trie trie; SymbolTable sym; Logger logger;
+    Analyzer az(trie, sym, logger);
+    az.setFormatIssues(false);
+    Tokenizer tk;
+
+    vector<Result> results;
+    for (const auto &shape : shapes){
+        for (size_t n=1000; n<=maxTokens; n *= 2){
+            string line = makeLine(shape.second, n, tk);
+            Result r;
+            r.shape = shape.first;
+            r.tokens = tk.tokenize(line).size();
+            az.processLine(line, 1); // warm-up
+            auto t0 = chrono::steady_clock::now();
+            for (int k=0; k<repeat; ++k) az.processLine(line, 1);
+            double secs = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+            r.msPerLine = secs * 1e3 / repeat;
+            r.nsPerToken = secs * 1e9 / repeat / r.tokens;
+            results.push_back(r);
+        }
+    }
+
+    if (json){
+        ofstream file;
+        if (!jsonPath.empty()){
+            file.open(jsonPath);
+            if (!file.is_open()){ cerr << "cannot write " << jsonPath << "\n"; return 1; }
+        }
+        ostream &out = jsonPath.empty() ? cout : file;
+        out << "{\n  \"benchmark\": \"analyzer_long_lines\",\n  \"results\": [\n";
+        for (size_t i=0; i<results.size(); ++i){
+            const auto &r = results[i];
+            out << "    {\"shape\": \"" << r.shape << "\", \"tokens\": " << r.tokens
+                << ", \"ms_per_line\": " << r.msPerLine << ", \"ns_per_token\": " << r.nsPerToken << "}"
+                << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+        if (!jsonPath.empty()) cout << "wrote " << jsonPath << "\n";
+        return 0;
+    }
+
+    cout << "  " << left << setw(18) << "shape" << right << setw(10) << "tokens" << setw(14) << "ms/line" << setw(14) << "ns/token" << "\n";
+    for (const auto &r : results){
+        cout << "  " << left << setw(18) << r.shape << right << setw(10) << r.tokens << fixed
+             << setw(14) << setprecision(2) << r.msPerLine << setw(14) << setprecision(1) << r.nsPerToken << "\n";
+    }
+    return 0;
+}
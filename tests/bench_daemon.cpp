@@ -0,0 +1,149 @@
+// Daemon request latency benchmark
+//
+// Build (from repo root, POSIX only):
+//   g++ -std=c++17 -O2 -pthread -I src tests/bench_daemon.cpp $(ls src/*.cpp | grep -v main.cpp) -o bench_daemon
+//
+// Usage:
+//   bench_daemon [--clients N] [--requests N] [--lines N] [--threads N]
+//
+// Compares what one correction costs a fresh process (dictionary + Analyzer
+// set-up, then the fix) with a request to a warm in-process daemon over its
+// Unix socket: single LINE requests from one client, then FIX requests of a
+// --lines buffer from --clients concurrent clients. Reports p50/p90/p99/max
+// latency in microseconds and the request rate.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Trie.h"
+#include "SymbolTable.h"
+#include "Utils.h"
+#include "Logger.h"
+#include "Daemon.h"
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+static double usSince(Clock::time_point t0){
+    return chrono::duration<double, micro>(Clock::now() - t0).count();
+}
+
+static void report(const string &name, vector<double> us, double wallSecs){
+    sort(us.begin(), us.end());
+    auto pct = [&](double p){ return us[min(us.size() - 1, (size_t)(p * us.size()))]; };
+    cout << "  " << left << setw(26) << name << right << fixed << setprecision(0)
+         << setw(9) << pct(0.50) << setw(9) << pct(0.90) << setw(9) << pct(0.99) << setw(10) << us.back()
+         << setw(12) << setprecision(0) << us.size() / wallSecs << "\n";
+}
+
+int main(int argc, char **argv){
+    int clients = 4, requests = 500;
+    size_t lines = 200;
+    unsigned threads = 0;
+    for (int i=1; i<argc; ++i){
+        string a = argv[i];
+        if (a == "--clients" && i+1 < argc) clients = max(1, atoi(argv[++i]));
+        else if (a == "--requests" && i+1 < argc) requests = max(1, atoi(argv[++i]));
+        else if (a == "--lines" && i+1 < argc) lines = max<size_t>(1, strtoull(argv[++i], nullptr, 10));
+        else if (a == "--threads" && i+1 < argc) threads = (unsigned)strtoul(argv[++i], nullptr, 10);
+        else if (a == "--help" || a == "-h"){
+            cout << "usage: bench_daemon [--clients N] [--requests N] [--lines N] [--threads N]\n";
+            return 0;
+        }
+    }
+#ifdef _WIN32
+    cerr << "bench_daemon needs Unix domain sockets\n";
+    return 1;
+#else
+    static const char *sample[] = {
+        "int main() {", "int x=5", "cout< x;", "for(i=0 i<10 i++){", "cout<<i", "}", "floot avg = valeu;", "return 0;", "}",
+    };
+    vector<string> buffer;
+    for (size_t i=0; i<lines; ++i) buffer.push_back(sample[i % (sizeof(sample) / sizeof(sample[0]))]);
+    const string oneLine = "cout< x";
+
+    cout << "  " << left << setw(26) << "latency (us)" << right << setw(9) << "p50" << setw(9) << "p90"
+         << setw(9) << "p99" << setw(10) << "max" << setw(12) << "req/s" << "\n";
+
+    // What a one-shot invocation pays before it can fix anything
+    {
+        const int cold = max(5, requests / 20);
+        vector<double> us;
+        auto wall = Clock::now();
+        for (int r=0; r<cold; ++r){
+            auto t0 = Clock::now();
+            Trie trie; SymbolTable sym; Logger logger;
+            Analyzer an(trie, sym, logger);
+            an.setThreads(1);
+            an.processLine(oneLine, 1);
+            us.push_back(usSince(t0));
+        }
+        report("cold start, one line", us, chrono::duration<double>(Clock::now() - wall).count());
+    }
+
+    string sock = (filesystem::temp_directory_path() / ("intellifix_bench_" + to_string(::getpid()) + ".sock")).string();
+    DaemonServer server(threads);
+    string error;
+    if (!server.listen(sock, &error)){ cerr << error << "\n"; return 1; }
+    thread serving([&]{ server.serve(); });
+
+    {
+        DaemonClient client;
+        if (!client.connect(sock, &error)){ cerr << error << "\n"; return 1; }
+        DaemonRequest req;
+        DaemonReply reply;
+        req.command = "LINE";
+        req.lines = {oneLine};
+        client.call(req, reply); // warm-up
+        vector<double> us;
+        auto wall = Clock::now();
+        for (int r=0; r<requests; ++r){
+            auto t0 = Clock::now();
+            if (!client.call(req, reply) || !reply.ok){ cerr << "LINE request failed\n"; return 1; }
+            us.push_back(usSince(t0));
+        }
+        report("daemon LINE, 1 client", us, chrono::duration<double>(Clock::now() - wall).count());
+    }
+
+    {
+        vector<vector<double>> perClient(clients);
+        vector<thread> pool;
+        auto wall = Clock::now();
+        for (int c=0; c<clients; ++c){
+            pool.emplace_back([&, c]{
+                DaemonClient client;
+                if (!client.connect(sock)) return;
+                DaemonRequest req;
+                DaemonReply reply;
+                req.command = "FIX";
+                req.lines = buffer;
+                for (int r=0; r<requests; ++r){
+                    auto t0 = Clock::now();
+                    if (!client.call(req, reply) || !reply.ok) return;
+                    perClient[c].push_back(usSince(t0));
+                }
+            });
+        }
+        for (auto &t : pool) t.join();
+        double secs = chrono::duration<double>(Clock::now() - wall).count();
+        vector<double> us;
+        for (auto &v : perClient) us.insert(us.end(), v.begin(), v.end());
+        if (us.size() != (size_t)clients * requests){ cerr << "FIX requests failed\n"; return 1; }
+        report("daemon FIX " + to_string(lines) + " lines, " + to_string(clients) + "c", us, secs);
+    }
+
+    server.stop();
+    serving.join();
+    return 0;
+#endif
+}
@@ -0,0 +1,264 @@
+// Tokenizer throughput / allocation benchmark
+//
+// Build (from repo root):
+//   g++ -std=c++17 -O2 -I src tests/bench_tokenizer.cpp src/Tokenizer.cpp src/TokenStream.cpp src/Utf8.cpp -o bench_tokenizer
+//
+// Usage:
+//   bench_tokenizer [--lines N] [--repeat R] [--json [file]] [file ...]
+//
+// Without files a synthetic corpus of N lines (default 100000) is generated.
+// Every corpus is tokenized through each Tokenizer API and the report lists
+// MB/s, tokens/s, heap allocations per line and p50/p99 per-line latency;
+// throughput and latency come from separate passes, so the per-line clock
+// reads do not slow down the throughput numbers.
+// --json writes the same numbers as JSON (to stdout or the given file) so two
+// commits can be compared.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Tokenizer.h"
+#include "TokenStream.h"
+
+using namespace std;
+
+// ---------- Instrumented allocator: counts every global operator new ----------
+static std::atomic<unsigned long long> g_allocs{0};
+static std::atomic<unsigned long long> g_allocBytes{0};
+
+void *operator new(size_t n){
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    g_allocBytes.fetch_add(n, std::memory_order_relaxed);
+    if (void *p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void *operator new[](size_t n){ return operator new(n); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+void operator delete[](void *p, size_t) noexcept { std::free(p); }
+
+// ---------- Corpora ----------
+struct Corpus {
+    string name;
+    vector<string> lines;
+    size_t bytes = 0;
+};
+
+// Deterministic mix of typical (and typo-ridden) C++ lines
+static Corpus syntheticCorpus(size_t count){
+    static const char *templates[] = {
+        "#include <iostream>",
+        "#inclde<iostreem",
+        "using namespace std;",
+        "int main() {",
+        "    int total = 0, count = 10;",
+        "    for(int i=0;i<count;i++){",
+        "        total += values[i] * weights[i];",
+        "        cout << \"value: \" << values[i] << endl;",
+        "    }",
+        "    cin> caravg",
+        "    floot caravg;",
+        "    std::vector<std::string> names = {\"alpha\", \"beta\", \"gamma\"};",
+        "    // compute the running average of the samples",
+        "    // calcule la moyenne des échantillons — Привет мир",
+        "    if (total >= 100 && count != 0) { return total / count; }",
+        "    string s = \"hello",
+        "    retun 0;",
+        "}",
+        "",
+    };
+    const size_t nt = sizeof(templates) / sizeof(templates[0]);
+    Corpus c;
+    c.name = "synthetic";
+    c.lines.reserve(count);
+    unsigned long long state = 0x9E3779B97F4A7C15ULL;
+    for (size_t i=0; i<count; ++i){
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        c.lines.push_back(templates[(state >> 33) % nt]);
+        c.bytes += c.lines.back().size() + 1;
+    }
+    return c;
+}
+
+static bool fileCorpus(const string &path, Corpus &c){
+    ifstream in(path);
+    if (!in.is_open()) return false;
+    c.name = path;
+    string s;
+    while (std::getline(in, s)){ c.bytes += s.size() + 1; c.lines.push_back(s); }
+    return true;
+}
+
+// ---------- Measurement ----------
+struct Result {
+    string corpus;
+    string api;
+    double seconds = 0;
+    double mbPerSec = 0;
+    double tokensPerSec = 0;
+    double allocsPerLine = 0;
+    double p50ns = 0;
+    double p99ns = 0;
+    size_t tokens = 0;
+};
+
+static double percentile(vector<double> &v, double p){
+    if (v.empty()) return 0;
+    size_t k = (size_t)(p * (v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+// tokenizeLine(line) must return the token count for that line
+template <class F>
+static Result measure(const Corpus &c, const string &api, int repeat, F tokenizeLine){
+    using clock = std::chrono::steady_clock;
+    Result r;
+    r.corpus = c.name;
+    r.api = api;
+    vector<double> lat;
+    lat.reserve(c.lines.size() * repeat);
+
+    // Warm-up pass so one-time buffer growth is not charged to the steady state
+    for (const auto &l : c.lines) tokenizeLine(l);
+
+    // Throughput pass: nothing but the tokenizer inside the timed loop
+    unsigned long long allocs0 = g_allocs.load();
+    auto t0 = clock::now();
+    for (int rep=0; rep<repeat; ++rep){
+        for (const auto &l : c.lines) r.tokens += tokenizeLine(l);
+    }
+    auto t1 = clock::now();
+    unsigned long long allocs = g_allocs.load() - allocs0;
+
+    // Latency pass, timed per line; its clock reads are not charged to MB/s
+    for (int rep=0; rep<repeat; ++rep){
+        for (const auto &l : c.lines){
+            auto a = clock::now();
+            tokenizeLine(l);
+            auto b = clock::now();
+            lat.push_back((double)std::chrono::duration_cast<std::chrono::nanoseconds>(b - a).count());
+        }
+    }
+
+    r.seconds = std::chrono::duration<double>(t1 - t0).count();
+    double totalBytes = (double)c.bytes * repeat;
+    double totalLines = (double)c.lines.size() * repeat;
+    r.mbPerSec = r.seconds > 0 ? totalBytes / (1024.0 * 1024.0) / r.seconds : 0;
+    r.tokensPerSec = r.seconds > 0 ? r.tokens / r.seconds : 0;
+    r.allocsPerLine = totalLines > 0 ? allocs / totalLines : 0;
+    r.p50ns = percentile(lat, 0.50);
+    r.p99ns = percentile(lat, 0.99);
+    return r;
+}
+
+static string jsonEscape(const string &s){
+    string o;
+    for (char ch : s){
+        if (ch == '"' || ch == '\\'){ o += '\\'; o += ch; }
+        else if ((unsigned char)ch < 0x20){ char buf[8]; snprintf(buf, sizeof buf, "\\u%04x", ch); o += buf; }
+        else o += ch;
+    }
+    return o;
+}
+
+static void writeJson(ostream &out, const vector<Result> &results){
+    out << "{\n  \"benchmark\": \"tokenizer\",\n  \"results\": [\n";
+    for (size_t i=0; i<results.size(); ++i){
+        const auto &r = results[i];
+        out << "    {\"corpus\": \"" << jsonEscape(r.corpus) << "\", \"api\": \"" << r.api << "\""
+            << ", \"seconds\": " << r.seconds
+            << ", \"mb_per_s\": " << r.mbPerSec
+            << ", \"tokens_per_s\": " << r.tokensPerSec
+            << ", \"tokens\": " << r.tokens
+            << ", \"allocs_per_line\": " << r.allocsPerLine
+            << ", \"p50_ns\": " << r.p50ns
+            << ", \"p99_ns\": " << r.p99ns << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+int main(int argc, char **argv){
+    size_t lines = 100000;
+    int repeat = 3;
+    bool json = false;
+    string jsonPath;
+    vector<string> files;
+    for (int i=1; i<argc; ++i){
+        string a = argv[i];
+        if (a == "--lines" && i+1 < argc) lines = std::strtoull(argv[++i], nullptr, 10);
+        else if (a == "--repeat" && i+1 < argc) repeat = std::max(1, atoi(argv[++i]));
+        else if (a == "--json"){
+            json = true;
+            if (i+1 < argc && argv[i+1][0] != '-') jsonPath = argv[++i];
+        }
+        else if (a == "--help" || a == "-h"){
+            cout << "usage: bench_tokenizer [--lines N] [--repeat R] [--json [file]] [file ...]\n";
+            return 0;
+        }
+        else files.push_back(a);
+    }
+
+    vector<Corpus> corpora;
+    if (files.empty()) corpora.push_back(syntheticCorpus(lines));
+    for (const auto &f : files){
+        Corpus c;
+        if (!fileCorpus(f, c)){ cerr << "cannot read " << f << "\n"; return 1; }
+        corpora.push_back(std::move(c));
+    }
+
+    Tokenizer tk;
+    vector<Result> results;
+    for (const auto &c : corpora){
+        results.push_back(measure(c, "tokenize(line)", repeat, [&](const string &l){
+            return tk.tokenize(l).size();
+        }));
+        vector<Token> buffer;
+        results.push_back(measure(c, "tokenize(line, vector&)", repeat, [&](const string &l){
+            tk.tokenize(l, buffer);
+            return buffer.size();
+        }));
+        TokenStream stream;
+        results.push_back(measure(c, "tokenize(line, TokenStream&)", repeat, [&](const string &l){
+            tk.tokenize(l, stream);
+            return stream.size();
+        }));
+    }
+
+    if (json){
+        if (jsonPath.empty()) writeJson(cout, results);
+        else {
+            ofstream out(jsonPath);
+            if (!out.is_open()){ cerr << "cannot write " << jsonPath << "\n"; return 1; }
+            writeJson(out, results);
+            cout << "wrote " << jsonPath << "\n";
+        }
+        return 0;
+    }
+
+    for (const auto &c : corpora){
+        cout << "corpus: " << c.name << " (" << c.lines.size() << " lines, " << c.bytes << " bytes, x" << repeat << ")\n";
+        cout << "  " << left << setw(30) << "api" << right << setw(10) << "MB/s" << setw(14) << "Mtok/s"
+             << setw(14) << "allocs/line" << setw(10) << "p50 ns" << setw(10) << "p99 ns" << "\n";
+        for (const auto &r : results){
+            if (r.corpus != c.name) continue;
+            cout << "  " << left << setw(30) << r.api << right << fixed << setprecision(1)
+                 << setw(10) << r.mbPerSec << setw(14) << setprecision(2) << r.tokensPerSec / 1e6
+                 << setw(14) << setprecision(3) << r.allocsPerLine
+                 << setw(10) << setprecision(0) << r.p50ns << setw(10) << r.p99ns << "\n";
+        }
+    }
+    return 0;
+}
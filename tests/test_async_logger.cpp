@@ -0,0 +1,152 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Logger.h"
+#include "MpscRing.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static string slurp(const fs::path &p){
+    ifstream in(p, ios::binary);
+    return string((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+}
+
+static void logSample(Logger &log){
+    log.issue(3, "Potential issues:\n - missing semicolon\n");
+    log.fix(7, "int x=5", "int x=5;", "Applied corrections:\n - added missing semicolon\n");
+    log.writeAnalysis({"[Decision] User applied correction", "second line"});
+}
+
+// The async Logger must write exactly what the synchronous one writes, lose
+// nothing under the Block policy with many producers, keep each producer's
+// order, and account for every record under the Drop policy.
+int main(){
+    int failures = 0;
+    auto check = [&](bool ok, const string &name){
+        cout << (ok ? "[PASS] " : "[FAIL] ") << name << "\n";
+        if (!ok) ++failures;
+    };
+    fs::path root = fs::temp_directory_path() / "intellifix_async_logger_test";
+    fs::remove_all(root);
+
+    // Ring basics
+    {
+        MpscRing<int> ring(3);
+        check(ring.capacity() == 4, "ring capacity rounds up to a power of two");
+        int v = 0;
+        bool pushed = true;
+        for (int i=0; i<4; ++i){ v = i; pushed = pushed && ring.tryPush(v); }
+        v = 99;
+        check(pushed && !ring.tryPush(v) && v == 99, "full ring refuses pushes and leaves the item alone");
+        int got = -1;
+        bool fifo = true;
+        for (int i=0; i<4; ++i) fifo = fifo && ring.tryPop(got) && got == i;
+        check(fifo && !ring.tryPop(got), "ring pops in push order, then reports empty");
+        v = 5;
+        check(ring.tryPush(v) && ring.tryPop(got) && got == 5, "ring slots are reused after wrap-around");
+    }
+
+    // Same bytes in both modes
+    {
+        Logger syncLog, asyncLog;
+        syncLog.init((root / "sync").string());
+        asyncLog.init((root / "async").string());
+        check(asyncLog.startAsync() && asyncLog.isAsync() && !asyncLog.startAsync(), "async mode starts once");
+        for (int i=0; i<3; ++i){ logSample(syncLog); logSample(asyncLog); }
+        syncLog.flush();
+        asyncLog.drain();
+        check(slurp(root / "sync" / "fixes.log") == slurp(root / "async" / "fixes.log") && !slurp(root / "async" / "fixes.log").empty(),
+              "fixes.log identical in sync and async mode");
+        check(slurp(root / "sync" / "analysis.txt") == slurp(root / "async" / "analysis.txt"), "analysis.txt identical in sync and async mode");
+        Logger closed;
+        check(!closed.startAsync(), "async mode needs open log files");
+    }
+
+    // Flush interval alone gets records to disk
+    {
+        Logger log;
+        log.init((root / "interval").string());
+        AsyncLogOptions opts;
+        opts.flushInterval = chrono::milliseconds(5);
+        log.startAsync(opts);
+        log.issue(1, "tick");
+        bool seen = false;
+        for (int i=0; i<400 && !seen; ++i){
+            this_thread::sleep_for(chrono::milliseconds(5));
+            seen = slurp(root / "interval" / "fixes.log").find("tick") != string::npos;
+        }
+        check(seen, "queued record written within the flush interval");
+    }
+
+    // Many producers, small ring, Block policy: nothing lost, per-thread order kept
+    const int producers = 4, perThread = 5000;
+    {
+        Logger log;
+        log.init((root / "block").string());
+        AsyncLogOptions opts;
+        opts.capacity = 64;
+        opts.whenFull = LogFullPolicy::Block;
+        log.startAsync(opts);
+        vector<thread> threads;
+        for (int t=0; t<producers; ++t){
+            threads.emplace_back([&log, t]{
+                for (int i=0; i<perThread; ++i) log.issue((size_t)i, "t" + to_string(t));
+            });
+        }
+        for (auto &th : threads) th.join();
+        log.stopAsync();
+        check(!log.isAsync() && log.dropped() == 0, "block policy drops nothing");
+
+        ifstream in(root / "block" / "fixes.log");
+        vector<int> next(producers, 0);
+        string line;
+        bool ordered = true;
+        size_t total = 0;
+        while (getline(in, line)){
+            size_t colon = line.find(": t");
+            if (colon == string::npos) continue;
+            int lineNo = stoi(line.substr(13, colon - 13));
+            int t = stoi(line.substr(colon + 3));
+            if (t < 0 || t >= producers || lineNo != next[t]) ordered = false;
+            else ++next[t];
+            ++total;
+        }
+        check(total == (size_t)producers * perThread, "every record from every thread written");
+        check(ordered, "each thread's records keep their order");
+    }
+
+    // Drop policy: written + dropped accounts for every record
+    {
+        Logger log;
+        log.init((root / "drop").string());
+        AsyncLogOptions opts;
+        opts.capacity = 16;
+        opts.flushInterval = chrono::milliseconds(1000);
+        opts.whenFull = LogFullPolicy::Drop;
+        log.startAsync(opts);
+        vector<thread> threads;
+        for (int t=0; t<producers; ++t){
+            threads.emplace_back([&log]{ for (int i=0; i<perThread; ++i) log.issue((size_t)i, "d"); });
+        }
+        for (auto &th : threads) th.join();
+        log.drain();
+        size_t written = 0;
+        {
+            ifstream in(root / "drop" / "fixes.log");
+            string line;
+            while (getline(in, line)) if (line.find("[Issue]") == 0) ++written;
+        }
+        check(written + log.dropped() == (size_t)producers * perThread, "drop policy: written + dropped = logged");
+        check(log.dropped() > 0, "drop policy discards when the ring is full");
+    }
+
+    fs::remove_all(root);
+    cout << "\nTotal Failures: " << failures << "\n";
+    return failures ? 1 : 0;
+}
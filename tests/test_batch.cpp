@@ -0,0 +1,122 @@
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Trie.h"
+#include "SymbolTable.h"
+#include "Utils.h"
+#include "Logger.h"
+#include "Batch.h"
+#include "ThreadPool.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// Batch mode must give every file the same output a lone Analyzer would, and
+// report files in sorted order regardless of thread count.
+static vector<string> readLines(const string &path){
+    ifstream in(path);
+    vector<string> lines;
+    string s;
+    while (std::getline(in, s)) lines.push_back(s);
+    return lines;
+}
+
+int main(){
+    int failures = 0;
+    auto check = [&](bool ok, const string &name){
+        cout << (ok ? "[PASS] " : "[FAIL] ") << name << "\n";
+        if (!ok) ++failures;
+    };
+
+    // Pool runs every task exactly once, including tasks submitted from tasks
+    {
+        WorkStealingPool pool(4);
+        atomic<int> sum{0};
+        for (int i=1; i<=1000; ++i) pool.submit([&sum, i](unsigned){ sum += i; });
+        pool.wait();
+        check(sum == 500500, "pool runs every task once");
+        atomic<int> nested{0};
+        pool.submit([&](unsigned){ for (int i=0; i<100; ++i) pool.submit([&nested](unsigned){ ++nested; }); });
+        pool.wait();
+        check(nested == 100, "tasks submitted from workers are waited for");
+    }
+
+    fs::path root = fs::temp_directory_path() / "intellifix_batch_test";
+    fs::remove_all(root);
+    fs::create_directories(root / "src" / "sub");
+    const vector<vector<string>> sources = {
+        {"#inclde<iostreem", "int main() {", "intx=5;", "cout< \"abdulhadi"},
+        {"for(i =0, i< 7;i+ +){", "cin> caravg", "floot caravg;", "}"},
+        {"while(a) {", "    retun 0;", "  ) ] }"},
+    };
+    const vector<string> names = {"src/b.cpp", "src/sub/a.h", "src/a.cpp"};
+    for (size_t i=0; i<names.size(); ++i){
+        ofstream out(root / names[i]);
+        for (auto &l : sources[i]) out << l << "\n";
+    }
+    ofstream(root / "src" / "notes.txt") << "ignored\n";
+    ofstream(root / "src" / "corrected_old.cpp") << "ignored\n";
+
+    auto files = BatchRunner::collect({(root / "src").string()});
+    check(files.size() == 3, "collect finds sources only (" + to_string(files.size()) + ")");
+    check(std::is_sorted(files.begin(), files.end()), "collected files are sorted");
+
+    Trie trie;
+    vector<vector<string>> reports;
+    for (unsigned threads : {1u, 3u}){
+        BatchRunner batch(trie);
+        batch.setThreads(threads);
+        batch.setOutputDir((root / ("out" + to_string(threads))).string());
+        auto results = batch.run(files);
+        bool ok = results.size() == files.size();
+        for (size_t i=0; ok && i<results.size(); ++i){
+            ok = results[i].ok && results[i].input == files[i];
+            // Same output as a dedicated Analyzer
+            Trie t; SymbolTable sym; Logger log;
+            Analyzer an(t, sym, log);
+            vector<string> issues;
+            ok = ok && readLines(results[i].output) == an.processFile(readLines(files[i]), issues);
+        }
+        check(ok, "threads=" + to_string(threads) + ": outputs match single-file processing");
+        auto report = BatchRunner::formatReport(results);
+        // Output paths differ by directory; compare the rest
+        for (auto &l : report){ auto p = l.find(" -> "); if (p != string::npos) l = l.substr(0, p); }
+        reports.push_back(report);
+    }
+    check(reports[0] == reports[1], "merged report is identical across thread counts");
+
+    {
+        BatchRunner full(trie), counts(trie);
+        full.setOutputDir((root / "full").string());
+        counts.setOutputDir((root / "counts").string());
+        counts.setCountOnly(true);
+        auto a = full.run(files), b = counts.run(files);
+        bool ok = a.size() == b.size();
+        for (size_t i=0; ok && i<a.size(); ++i) ok = a[i].issueCount == b[i].issueCount && a[i].issueCount == a[i].issues.size() && b[i].issues.empty();
+        check(ok, "count-only mode counts the same issues without messages");
+    }
+
+    {
+        // A ../ input still lands under --out, never next to the input
+        fs::create_directories(root / "work");
+        fs::create_directories(root / "other");
+        ofstream(root / "other" / "a.cpp") << "intx=5;\n";
+        fs::path cwd = fs::current_path();
+        fs::current_path(root / "work");
+        BatchRunner batch(trie);
+        batch.setOutputDir("out");
+        auto results = batch.run({"../other/a.cpp"});
+        fs::current_path(cwd);
+        check(results.size() == 1 && results[0].ok && fs::exists(root / "work" / "out" / "other" / "corrected_a.cpp")
+              && !fs::exists(root / "work" / "other") && !fs::exists(root / "other" / "corrected_a.cpp"),
+              "../ input is written inside the output directory");
+    }
+
+    fs::remove_all(root);
+    cout << "\nTotal Failures: " << failures << endl;
+    return failures == 0 ? 0 : 1;
+}
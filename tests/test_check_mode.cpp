@@ -0,0 +1,78 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Trie.h"
+#include "SymbolTable.h"
+#include "Utils.h"
+#include "Logger.h"
+#include "Batch.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// Check mode must flag exactly the files processFile would change (or report
+// issues for), stop at the requested number of issues, and write nothing.
+int main(){
+    Trie trie; SymbolTable sym; Logger logger;
+    int failures = 0;
+    auto check = [&](bool ok, const string &name){
+        cout << (ok ? "[PASS] " : "[FAIL] ") << name << "\n";
+        if (!ok) ++failures;
+    };
+    auto flagged = [&](const vector<string> &lines){
+        Analyzer an(trie, sym, logger);
+        vector<string> fileIssues;
+        vector<Issue> records;
+        an.setIssueSink(&records);
+        bool changes = an.processFile(lines, fileIssues) != lines || !fileIssues.empty() || !records.empty();
+        Analyzer ck(trie, sym, logger);
+        return make_pair(ck.checkFile(lines) > 0, changes);
+    };
+
+    const vector<vector<string>> cases = {
+        {"int main() {", "    return 0;", "}"},
+        {"int main() {", "return 0;", "}"},                 // indentation only
+        {"int main() {", "    int x = 5;"},                  // missing '}' at end of file
+        {"#inclde<iostreem", "int main() {", "}"},
+        {"int main() {", "    cout< x;", "}"},
+        {"int main() {", "    return 0; ", "}"},             // trailing whitespace
+        {"}"},
+        {},
+    };
+    for (size_t i=0; i<cases.size(); ++i){
+        auto r = flagged(cases[i]);
+        check(r.first == r.second, "case " + to_string(i) + ": check agrees with processFile (" + (r.first ? "flagged" : "clean") + ")");
+    }
+
+    {
+        Analyzer an(trie, sym, logger);
+        vector<string> lines(100, "cout< x");
+        vector<Issue> records;
+        check(an.checkFile(lines, 3, &records) == 3 && records.size() == 3 && records[2].line == 2, "stops after maxIssues");
+        vector<Issue> all;
+        check(an.checkFile(lines, SIZE_MAX, &all) >= 200, "unbounded check sees every line");
+        records.clear();
+        an.checkFile({"int main() {"}, 5, &records);
+        check(!records.empty() && records.back().line == 0 && an.formatIssue(records.back()).find("missing closing '}'") != string::npos,
+              "end-of-file brace issue has line 0");
+    }
+
+    fs::path root = fs::temp_directory_path() / "intellifix_check_test";
+    fs::remove_all(root);
+    fs::create_directories(root);
+    { ofstream(root / "clean.cpp") << "int main() {\n    return 0;\n}\n"; }
+    { ofstream(root / "dirty.cpp") << "int main() {\ncout< x;\n}\n"; }
+    BatchRunner batch(trie);
+    batch.setCheckOnly(1);
+    auto results = batch.run(BatchRunner::collect({root.string()}));
+    check(results.size() == 2 && results[0].checked && results[0].issueCount == 0 && results[1].issueCount == 1
+          && results[1].issues.size() == 1 && results[1].issues[0].rfind("line 2: ", 0) == 0, "batch check flags only the dirty file");
+    check(!fs::exists(root / "corrected_dirty.cpp") && results[1].output.empty(), "check mode writes no output");
+    fs::remove_all(root);
+
+    cout << "\nTotal Failures: " << failures << endl;
+    return failures == 0 ? 0 : 1;
+}
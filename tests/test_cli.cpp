@@ -0,0 +1,104 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Cli.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// The headless driver: argument parsing, exit status, and where each kind of
+// output ends up. Nothing here may read the real stdin.
+int main(){
+    int failures = 0;
+    auto check = [&](bool ok, const string &name){
+        cout << (ok ? "[PASS] " : "[FAIL] ") << name << "\n";
+        if (!ok) ++failures;
+    };
+    auto parse = [](const vector<string> &args, CliOptions &opts){
+        opts = CliOptions();
+        string error;
+        return parseCliArgs(args, opts, error);
+    };
+
+    CliOptions opts;
+    check(parse({"-o", "out", "--log=logs", "-j", "4", "--diff", "a.cpp", "src"}, opts)
+          && opts.outDir == "out" && opts.logDir == "logs" && opts.threads == 4 && opts.diff
+          && opts.inputs == vector<string>{"a.cpp", "src"}, "options and inputs");
+    check(parse({"--check", "--max-issues", "5", "x.cpp"}, opts) && opts.check && opts.maxIssues == 5, "check options");
+    check(parse({"--", "-odd.cpp"}, opts) && opts.inputs == vector<string>{"-odd.cpp"}, "-- ends the options");
+    check(parse({"--help"}, opts) && opts.help && parse({"-i"}, opts) && opts.interactive, "help and interactive need no inputs");
+    check(!parse({}, opts) && !parse({"-j", "many", "a.cpp"}, opts) && !parse({"--max-issues=0", "a.cpp"}, opts)
+          && !parse({"--frobnicate", "a.cpp"}, opts) && !parse({"a.cpp", "-o"}, opts) && !parse({"--diff=yes", "a.cpp"}, opts)
+          && !parse({"--check", "--diff", "a.cpp"}, opts) && !parse({"-", "a.cpp"}, opts) && !parse({"-", "--diff"}, opts), "bad usage is rejected");
+    check(parse({"--harvest", "src"}, opts) && opts.harvest && parse({"--serve", "s.sock", "--harvest"}, opts) && opts.harvest
+          && !parse({"-", "--harvest"}, opts) && !parse({"--lsp", "--harvest"}, opts), "--harvest needs whole files");
+    check(parse({"-", "--issues-fd", "3"}, opts) && opts.filter && opts.issuesFd == 3 && parse({"--filter"}, opts) && opts.filter,
+          "filter mode needs no inputs");
+    check(!defaultLogDir().empty() && defaultLogDir().find("iComputers") == string::npos, "default log dir");
+
+    fs::path root = fs::temp_directory_path() / "intellifix_cli_test";
+    fs::remove_all(root);
+    fs::create_directories(root / "src");
+    { ofstream(root / "src" / "clean.cpp") << "int main() {\n    return 0;\n}\n"; }
+    { ofstream(root / "src" / "dirty.cpp") << "int main() {\n    cout< x;\n}\n"; }
+    const string src = (root / "src").string();
+
+    auto run = [&](const vector<string> &args, string &out, string &err){
+        CliOptions o;
+        string error;
+        if (!parseCliArgs(args, o, error)) return -1;
+        ostringstream os, es;
+        int rc = runCli(o, os, es);
+        out = os.str(); err = es.str();
+        return rc;
+    };
+    string out, err;
+
+    int rc = run({"--check", src}, out, err);
+    check(rc == 1 && out.find("dirty.cpp: line 2: ") != string::npos && out.find("clean.cpp") == string::npos
+          && err.find("2 file(s) checked, 1 need fixes") != string::npos, "check mode exits 1 and names the file");
+    check(!fs::exists(root / "src" / "corrected_dirty.cpp"), "check mode writes nothing");
+
+    rc = run({"-o", (root / "out").string(), "-l", (root / "logs").string(), "-j", "2", src}, out, err);
+    // Copies mirror each input's path under the output dir
+    fs::path mirrored = root / "out" / fs::path(src).relative_path();
+    check(rc == 0 && fs::exists(mirrored / "corrected_dirty.cpp") && fs::exists(mirrored / "corrected_clean.cpp")
+          && !fs::exists(root / "src" / "corrected_dirty.cpp"), "fix mode writes to the output dir");
+    check(fs::exists(root / "logs" / "batch_report.txt") && fs::exists(root / "logs" / "fixes.log"), "logs go to the log dir");
+    check(err.find("Batch report: 2 files") != string::npos && out.find("dirty.cpp: line 2: ") != string::npos, "issues on out, summary on err");
+
+    rc = run({"--diff", "-q", src}, out, err);
+    check(rc == 0 && out.rfind("--- ", 0) == 0 && out.find("+    cout<< x;") != string::npos && err.find("line 2") == string::npos,
+          "diff without an output dir goes to out, alone");
+
+    rc = run({"--check", (root / "missing.cpp").string(), src}, out, err);
+    check(rc == 2, "missing input exits 2");
+
+    // Filter mode on plain files standing in for stdin, stdout and the issues fd
+    {
+        { ofstream(root / "in.cpp") << "int main() {\nint x=5\n"; }
+        FILE *in = fopen((root / "in.cpp").string().c_str(), "rb");
+        FILE *fixed = fopen((root / "fixed.cpp").string().c_str(), "wb");
+        FILE *issues = fopen((root / "issues.txt").string().c_str(), "wb");
+        CliOptions o;
+        o.filter = true;
+        o.stdinName = "buf.cpp";
+        rc = runFilter(o, fileno(in), fileno(fixed), fileno(issues));
+        fclose(in); fclose(fixed); fclose(issues);
+        auto slurp = [](const fs::path &p){ ifstream f(p); return string((istreambuf_iterator<char>(f)), istreambuf_iterator<char>()); };
+        string text = slurp(root / "fixed.cpp"), found = slurp(root / "issues.txt");
+        check(rc == 0 && text == "int main() {\n    int x=5;\n}\n", "filter writes the fixed source");
+        check(found.rfind("buf.cpp: line 2: added missing semicolon\n", 0) == 0
+              && found.find("buf.cpp: inserted missing closing '}'") != string::npos, "filter writes issues to their own fd");
+    }
+
+    fs::remove_all(root);
+
+    cout << "\nTotal Failures: " << failures << endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,172 @@
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Trie.h"
+#include "SymbolTable.h"
+#include "Utils.h"
+#include "Logger.h"
+#include "Daemon.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// The daemon must answer exactly what a local Analyzer gives, to many clients
+// at once, and survive malformed input.
+int main(){
+    int failures = 0;
+    auto check = [&](bool ok, const string &name){
+        cout << (ok ? "[PASS] " : "[FAIL] ") << name << "\n";
+        if (!ok) ++failures;
+    };
+
+    // Protocol round trips, no sockets involved
+    {
+        DaemonRequest req, back;
+        req.command = "RANGE"; req.first = 2; req.last = 5;
+        req.lines = {"int x=5", "", "cout< x;"};
+        check(decodeRequest(encodeRequest(req), back) && back.command == "RANGE" && back.first == 2 && back.last == 5
+              && back.lines == req.lines, "request round trip");
+        DaemonReply rep, got;
+        rep.ok = true; rep.lines = {"a", ""}; rep.issues = {"line 1: x"};
+        check(decodeReply(encodeReply(rep), got) && got.ok && got.lines == rep.lines && got.issues == rep.issues, "reply round trip");
+        check(!decodeRequest("RANGE 3 1\n", back) && !decodeRequest("EXPLODE\n", back) && !decodeRequest("LINE\na\nb\n", back),
+              "bad requests are rejected");
+
+        string buf;
+        appendFrame(buf, "hello");
+        appendFrame(buf, "");
+        string payload;
+        size_t pos = 0;
+        check(takeFrame(buf.substr(0, 7), pos, payload) == FrameStatus::NEED_MORE && pos == 0, "partial frame waits");
+        check(takeFrame(buf, pos, payload) == FrameStatus::FRAME && payload == "hello"
+              && takeFrame(buf, pos, payload) == FrameStatus::FRAME && payload.empty() && pos == buf.size(), "frames split");
+        string huge = string("\x7f\xff\xff\xff", 4);
+        pos = 0;
+        check(takeFrame(huge, pos, payload) == FrameStatus::TOO_LARGE, "oversized frame is refused");
+    }
+
+#ifndef _WIN32
+    fs::path sock = fs::temp_directory_path() / "intellifix_test_daemon.sock";
+    DaemonServer server(2);
+    string error;
+    check(server.listen(sock.string(), &error), "listen on a temp socket " + error);
+    check((fs::status(sock).permissions() & fs::perms::all) == (fs::perms::owner_read | fs::perms::owner_write),
+          "socket is private to its owner");
+    thread serving([&]{ server.serve(); });
+
+    Trie trie; SymbolTable sym; Logger logger;
+    Analyzer local(trie, sym, logger);
+    local.setThreads(1);
+    const vector<string> file = {"#inclde<iostreem", "int main() {", "int x=5", "cout< x;", "for(i=0 i<10 i++){", "cout<<i", "}"};
+    vector<string> fileIssues;
+    auto expected = local.processFile(file, fileIssues);
+
+    {
+        DaemonClient client;
+        check(client.connect(sock.string(), &error), "connect");
+        DaemonRequest req;
+        DaemonReply reply;
+        req.command = "FIX"; req.lines = file;
+        check(client.call(req, reply) && reply.ok && reply.lines == expected, "FIX matches processFile");
+        check(!reply.issues.empty() && reply.issues.back() == fileIssues.back(), "FIX returns the end-of-file issues");
+
+        req.command = "RANGE"; req.first = 3; req.last = 4;
+        check(client.call(req, reply) && reply.ok && reply.lines == vector<string>(expected.begin() + 2, expected.begin() + 4)
+              && reply.issues.size() >= 2 && reply.issues[0].rfind("line 3: ", 0) == 0, "RANGE returns its lines with file context");
+
+        req.command = "LINE"; req.lines = {"cout< x;"};
+        check(client.call(req, reply) && reply.ok && reply.lines == vector<string>{"cout<< x;"}, "LINE");
+
+        req.command = "RANGE"; req.first = 50; req.last = 60; req.lines = file;
+        check(client.call(req, reply) && !reply.ok && !reply.error.empty(), "RANGE past the end is an error");
+
+        string raw;
+        check(client.call("BOGUS\n", raw) && raw.rfind("ERR ", 0) == 0, "unknown command gets ERR");
+        check(client.call("PING\n", raw) && raw == "OK 0 0\n", "connection still usable after an error");
+    }
+
+    // Many clients at once, each checking its own answers
+    {
+        const int kClients = 8, kRequests = 25;
+        // Expected answers up front: Analyzers share the trie, which is only read concurrently
+        vector<vector<string>> inputs, answers;
+        for (int k=0; k<kClients * kRequests; ++k){
+            inputs.push_back(file);
+            inputs.back().push_back("int v" + to_string(k) + " = 0");
+            vector<string> fi;
+            answers.push_back(local.processFile(inputs.back(), fi));
+        }
+        vector<int> wrong(kClients, 0);
+        vector<thread> clients;
+        for (int c=0; c<kClients; ++c){
+            clients.emplace_back([&, c]{
+                DaemonClient client;
+                if (!client.connect(sock.string())){ wrong[c] = kRequests; return; }
+                for (int r=0; r<kRequests; ++r){
+                    DaemonRequest req;
+                    DaemonReply reply;
+                    req.command = "FIX";
+                    req.lines = inputs[c * kRequests + r];
+                    if (!client.call(req, reply) || reply.lines != answers[c * kRequests + r]) ++wrong[c];
+                }
+            });
+        }
+        for (auto &t : clients) t.join();
+        int total = 0;
+        for (int w : wrong) total += w;
+        check(total == 0, "concurrent clients get their own answers");
+    }
+
+    // A worker lives as long as the daemon: words quoted by one request's issues
+    // must not pile up across requests
+    {
+        fs::path sock1 = fs::temp_directory_path() / "intellifix_test_daemon_names.sock";
+        DaemonServer single(1);
+        check(single.listen(sock1.string(), &error), "listen with one worker " + error);
+        thread singleServing([&]{ single.serve(); });
+        vector<string> typos;
+        for (string w : {"return", "while", "cout", "double", "float", "struct", "class", "switch", "string", "vector",
+                         "public", "private", "continue", "unsigned", "namespace", "template", "static", "virtual"}){
+            for (size_t i=0; i<w.size(); ++i) typos.push_back(string(w).erase(i, 1));
+        }
+        DaemonClient client;
+        size_t quoted = 0;
+        bool ok = client.connect(sock1.string());
+        for (size_t k=0; ok && k<typos.size(); ++k){
+            DaemonRequest req;
+            DaemonReply reply;
+            req.command = "FIX";
+            req.lines = {"int main() {", "    " + typos[k] + " x;", "}"};
+            ok = client.call(req, reply) && reply.ok;
+            for (auto &issue : reply.issues) if (issue.find("'" + typos[k] + "'") != string::npos){ ++quoted; break; }
+        }
+        DaemonRequest req;
+        DaemonReply reply;
+        req.command = "STATS";
+        size_t names = 0;
+        ok = ok && client.call(req, reply);
+        for (auto &l : reply.lines) if (l.rfind("issue_names ", 0) == 0) names = stoul(l.substr(12));
+        check(ok && quoted > typos.size() / 2, "distinct typos reported by one worker");
+        check(names > 0 && names < 16, "worker's issue words stay bounded (" + to_string(names) + " after " + to_string(quoted) + " typos)");
+        string raw;
+        client.call("SHUTDOWN\n", raw);
+        singleServing.join();
+    }
+
+    {
+        DaemonClient client;
+        string raw;
+        check(client.connect(sock.string()) && client.call("SHUTDOWN\n", raw) && raw == "OK 0 0\n", "SHUTDOWN is answered");
+    }
+    serving.join();
+    auto st = server.stats();
+    check(st.requests >= 200 && st.errors == 1, "stats count requests and errors");
+    check(!fs::exists(sock), "socket file removed on exit");
+#endif
+
+    cout << "\nTotal Failures: " << failures << endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,102 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Trie.h"
+#include "SymbolTable.h"
+#include "Utils.h"
+#include "Logger.h"
+#include "DiffWriter.h"
+
+using namespace std;
+
+// Diffs are built from the per-line changes alone: hunk ranges, context
+// merging, lines appended at end of file, a missing final newline, and the
+// streaming writer must agree
+// with the whole-file one.
+static string diffOf(const vector<string> &a, const vector<string> &b, bool aEndsWithNewline = true){
+    ostringstream out;
+    DiffWriter::write(out, "f.cpp", "f.cpp", a, b, 3, aEndsWithNewline);
+    return out.str();
+}
+
+int main(){
+    int failures = 0;
+    auto check = [&](bool ok, const string &name){
+        cout << (ok ? "[PASS] " : "[FAIL] ") << name << "\n";
+        if (!ok) ++failures;
+    };
+
+    vector<string> a;
+    for (int i=1; i<=20; ++i) a.push_back("l" + to_string(i));
+
+    check(diffOf(a, a).empty(), "no changes, no output");
+
+    auto b = a; b[9] = "X";
+    check(diffOf(a, b) == "--- f.cpp\n+++ f.cpp\n@@ -7,7 +7,7 @@\n l7\n l8\n l9\n-l10\n+X\n l11\n l12\n l13\n",
+          "single change with three lines of context");
+
+    b = a; b[0] = "X"; b[19] = "Y";
+    string d = diffOf(a, b);
+    check(d.find("@@ -1,4 +1,4 @@\n-l1\n+X\n l2\n l3\n l4\n") != string::npos
+          && d.find("@@ -17,4 +17,4 @@\n l17\n l18\n l19\n-l20\n+Y\n") != string::npos, "distant changes give two hunks");
+
+    auto hunks = [](const string &diff){
+        size_t n = 0;
+        for (size_t p = diff.find("\n@@ "); p != string::npos; p = diff.find("\n@@ ", p + 1)) ++n;
+        return n;
+    };
+    b = a; b[4] = "X"; b[10] = "Y"; // 5 unchanged lines between: within 2*3 context
+    check(hunks(diffOf(a, b)) == 1 && diffOf(a, b).find("@@ -2,13 +2,13 @@\n") != string::npos, "close changes merge into one hunk");
+    b = a; b[4] = "X"; b[12] = "Y"; // 7 unchanged lines between
+    check(hunks(diffOf(a, b)) == 2, "changes further apart than 2*context split");
+
+    b = a; b.push_back("}");
+    check(diffOf(a, b) == "--- f.cpp\n+++ f.cpp\n@@ -18,3 +18,4 @@\n l18\n l19\n l20\n+}\n", "appended line at end of file");
+    check(diffOf({}, {"}"}) == "--- f.cpp\n+++ f.cpp\n@@ -0,0 +1,1 @@\n+}\n", "addition to an empty file");
+
+    // No newline at end of the input: the fixed output adds one
+    const string noEol = "\\ No newline at end of file\n";
+    check(diffOf(a, a, false) == "--- f.cpp\n+++ f.cpp\n@@ -18,3 +18,3 @@\n l18\n l19\n-l20\n" + noEol + "+l20\n",
+          "missing final newline alone is a change");
+    b = a; b[9] = "X";
+    check(diffOf(a, b, false) == "--- f.cpp\n+++ f.cpp\n@@ -7,7 +7,7 @@\n l7\n l8\n l9\n-l10\n+X\n l11\n l12\n l13\n"
+                                 "@@ -18,3 +18,3 @@\n l18\n l19\n-l20\n" + noEol + "+l20\n", "far from other changes it gets its own hunk");
+    b = a; b[18] = "X";
+    check(diffOf(a, b, false) == "--- f.cpp\n+++ f.cpp\n@@ -16,5 +16,5 @@\n l16\n l17\n l18\n-l19\n+X\n-l20\n" + noEol + "+l20\n",
+          "trailing context line joins the change");
+    b = a; b[19] = "X";
+    check(diffOf(a, b, false) == "--- f.cpp\n+++ f.cpp\n@@ -17,4 +17,4 @@\n l17\n l18\n l19\n-l20\n" + noEol + "+X\n",
+          "marker follows a changed last line");
+    b = a; b.push_back("}");
+    check(diffOf(a, b, false) == "--- f.cpp\n+++ f.cpp\n@@ -18,3 +18,4 @@\n l18\n l19\n-l20\n" + noEol + "+l20\n+}\n",
+          "line appended after a last line without newline");
+
+    // Streaming diff of a fix run equals the diff of processFile's output
+    Trie trie; SymbolTable sym; Logger logger;
+    vector<string> src = {"#inclde<iostreem", "int main() {", "    int x = 5;", "", "", "", "", "", "", "", "",
+                          "cout< \"abdulhadi", "    return 0;", "int tail() {"};
+    string text;
+    for (auto &l : src) text += l + "\n";
+    Analyzer ref(trie, sym, logger);
+    vector<string> issues;
+    auto fixed = ref.processFile(src, issues);
+    Analyzer an(trie, sym, logger);
+    istringstream in(text);
+    ostringstream streamed;
+    DiffWriter diff(streamed, "f.cpp", "f.cpp");
+    size_t n = an.processStream(in, diff, issues);
+    check(n == src.size() && streamed.str() == diffOf(src, fixed) && diff.hunks() == 1, "streamed diff matches whole-file diff");
+
+    text.pop_back();
+    istringstream inNoEol(text);
+    ostringstream streamedNoEol;
+    DiffWriter diffNoEol(streamedNoEol, "f.cpp", "f.cpp");
+    an.processStream(inNoEol, diffNoEol, issues);
+    check(streamedNoEol.str() == diffOf(src, fixed, false) && streamedNoEol.str().find("\\ No newline") != string::npos,
+          "streamed diff notices a missing final newline");
+
+    cout << "\nTotal Failures: " << failures << endl;
+    return failures == 0 ? 0 : 1;
+}
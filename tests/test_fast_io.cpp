@@ -0,0 +1,66 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "FastIO.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// FdReader must split exactly like std::getline, whatever the buffer size;
+// FdWriter must write everything, in order.
+int main(){
+    int failures = 0;
+    auto check = [&](bool ok, const string &name){
+        cout << (ok ? "[PASS] " : "[FAIL] ") << name << "\n";
+        if (!ok) ++failures;
+    };
+
+    fs::path path = fs::temp_directory_path() / "intellifix_fast_io_test.txt";
+    string text = "first\n\nwith cr\r\n" + string(5000, 'x') + "\nlast without newline";
+    { ofstream(path, ios::binary) << text; }
+
+    vector<string> expected;
+    { ifstream in(path, ios::binary); string l; while (getline(in, l)) expected.push_back(l); }
+
+    for (size_t bufferSize : vector<size_t>{1, 7, 64, 4096, FdReader::kDefaultBuffer}){
+        FILE *f = fopen(path.string().c_str(), "rb");
+        FdReader reader(fileno(f), bufferSize);
+        vector<string> got;
+        string line;
+        while (reader.readLine(line)) got.push_back(line);
+        check(got == expected && !reader.failed() && reader.lineReady(), "reader with a " + to_string(bufferSize) + "-byte buffer splits like getline");
+        fclose(f);
+    }
+
+    {
+        FILE *f = fopen(path.string().c_str(), "wb");
+        {
+            FdWriter writer(fileno(f), 16);
+            writer.writeLine("short");
+            writer.write(string(100, 'y'));   // bigger than the buffer
+            writer.put('\n');
+            for (int i=0; i<50; ++i) writer.write("ab");
+            check(writer.flush(), "writer flush succeeds");
+        }
+        fclose(f);
+        ifstream in(path, ios::binary);
+        string back((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+        string want = "short\n" + string(100, 'y') + "\n";
+        for (int i=0; i<50; ++i) want += "ab";
+        check(back == want, "writer output is complete and in order");
+    }
+
+    {
+        FdWriter writer(-1, 8);
+        writer.write("lost");
+        check(!writer.flush() && writer.failed(), "write errors are reported");
+    }
+
+    fs::remove(path);
+    cout << "\nTotal Failures: " << failures << endl;
+    return failures == 0 ? 0 : 1;
+}
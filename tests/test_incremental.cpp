@@ -0,0 +1,130 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Trie.h"
+#include "SymbolTable.h"
+#include "Utils.h"
+#include "Logger.h"
+#include "IncrementalSession.h"
+
+using namespace std;
+
+// After any edit, an incremental run must give exactly what a fresh
+// processFile gives, while re-running only the lines the edit can reach.
+static vector<string> makeFile(size_t n){
+    static const char *lines[] = {
+        "int helper(int v) {", "    int out = v * 2;", "    out = out + 1;", "    retun out;", "}",
+        "void loop() {", "for(i =0, i< 7;i+ +){", "cout< \"abdulhadi", "}", "}",
+        "floot caravg = valeu;", "cin> caravg", "intx=5;", "// a comment", "",
+    };
+    const size_t k = sizeof(lines) / sizeof(lines[0]);
+    vector<string> out;
+    for (size_t i=0; i<n; ++i) out.push_back(lines[i % k]);
+    return out;
+}
+
+int main(){
+    Trie trie; Logger logger;
+    int failures = 0;
+    auto check = [&](bool ok, const string &name){
+        cout << (ok ? "[PASS] " : "[FAIL] ") << name << "\n";
+        if (!ok) ++failures;
+    };
+
+    SymbolTable sym;
+    Analyzer an(trie, sym, logger);
+    an.setThreads(1);
+    IncrementalSession session(an);
+    vector<string> file = makeFile(3000);
+
+    auto same = [&](const string &name){
+        SymbolTable freshSym;
+        Analyzer fresh(trie, freshSym, logger);
+        fresh.setThreads(1);
+        vector<string> expIssues, gotIssues;
+        vector<Issue> expRecords;
+        fresh.setIssueSink(&expRecords);
+        auto expected = fresh.processFile(file, expIssues);
+        auto got = session.process(file, gotIssues);
+        auto st = session.lastStats();
+        cout << "  " << name << ": rerun " << st.rerun << ", reused " << st.reused << ", replayed " << st.replayed << "\n";
+        check(got == expected && gotIssues == expIssues, name + ": matches processFile");
+        size_t k = 0;
+        bool records = true;
+        for (size_t i=0; i<file.size() && records; ++i){
+            for (auto &issue : session.lineRecords(i)){
+                records = k < expRecords.size() && issue.line == expRecords[k].line && issue.code == expRecords[k].code
+                          && issue.column == expRecords[k].column;
+                ++k;
+                if (!records) break;
+            }
+        }
+        check(records && k == expRecords.size(), name + ": issue records carry the current line numbers");
+        return st;
+    };
+
+    auto st = same("first run");
+    check(st.rerun == file.size(), "first run processes every line");
+
+    st = same("no change");
+    check(st.rerun == 0 && st.reused == file.size(), "unchanged file is fully reused");
+
+    file[1502] = "    out = out + 2;";
+    st = same("edit one line");
+    check(st.rerun <= 2 && st.replayed < IncrementalSession::kSnapshotEvery, "one-line edit re-runs about one line");
+
+    file.insert(file.begin() + 700, "cout< extra;");
+    st = same("insert line");
+    check(st.rerun < 20, "inserted line resyncs quickly");
+
+    file.erase(file.begin() + 100, file.begin() + 103);
+    same("delete lines");
+
+    file.insert(file.begin() + 2000, "void open() {");
+    st = same("unbalanced brace");
+    check(st.rerun == file.size() - 2000, "brace change re-runs to the end");
+
+    file.erase(file.begin() + 2000);
+    same("brace removed again");
+
+    file.resize(2500);
+    same("truncate");
+
+    file.push_back("int tail() {");
+    same("append");
+
+    file.insert(file.begin(), "#inclde<iostreem");
+    same("insert at top");
+
+    check(!session.lineIssues(0).empty() && session.lineIssues(1).empty(), "per-line issues are kept");
+
+    // An issue below an inserted line moves down with its line
+    size_t at = 0;
+    while (file[at] != "    retun out;") ++at;
+    file.insert(file.begin() + at - 1, "    int added = 0;");
+    same("insert above an issue");
+    check(!session.lineRecords(at + 1).empty() && session.lineRecords(at + 1)[0].line == at + 2,
+          "reused issue reported on its new line");
+
+    // An empty first run still leaves a state to resume from
+    {
+        SymbolTable emptySym;
+        Analyzer emptyAn(trie, emptySym, logger);
+        emptyAn.setThreads(1);
+        IncrementalSession fromEmpty(emptyAn);
+        vector<string> issues;
+        check(fromEmpty.process({}, issues).empty(), "empty file gives no lines");
+        vector<string> grown = {"int x = 5", "cout < x"};
+        SymbolTable freshSym;
+        Analyzer fresh(trie, freshSym, logger);
+        fresh.setThreads(1);
+        vector<string> expIssues, gotIssues;
+        auto expected = fresh.processFile(grown, expIssues);
+        auto got = fromEmpty.process(grown, gotIssues);
+        check(got == expected && gotIssues == expIssues, "empty then non-empty matches processFile");
+    }
+
+    cout << "\nTotal Failures: " << failures << endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Trie.h"
+#include "SymbolTable.h"
+#include "Utils.h"
+#include "Logger.h"
+
+using namespace std;
+
+// Issues are recorded as (code, line, column, word ids); the text form is only
+// built on demand and matches the historical messages.
+int main(){
+    Trie trie; SymbolTable sym; Logger logger;
+    int failures = 0;
+    auto check = [&](bool ok, const string &name){
+        cout << (ok ? "[PASS] " : "[FAIL] ") << name << "\n";
+        if (!ok) ++failures;
+    };
+
+    Analyzer az(trie, sym, logger);
+    auto res = az.processLine("cot< x", 3);
+    bool same = res.records.size() == res.issues.size();
+    for (size_t i=0; same && i<res.records.size(); ++i) same = az.formatIssue(res.records[i]) == res.issues[i];
+    check(same && !res.records.empty(), "formatted records match LineResult::issues");
+    check(res.records[0].code == IssueCode::IDENTIFIER && res.records[0].line == 3 && res.records[0].column == 1,
+          "identifier fix recorded with line and column");
+    check(az.issueNames().str(res.records[0].a) == "cot" && az.issueNames().str(res.records[0].b) == "cout",
+          "identifier record quotes both words");
+    bool op = false;
+    for (auto &r : res.records) op = op || (r.code == IssueCode::COUT_OPERATOR && r.column == 4);
+    check(op, "stream operator fix recorded at its source column");
+
+    auto semi = az.processLine("x = 5", 4);
+    check(!semi.records.empty() && semi.records[0].code == IssueCode::MISSING_SEMICOLON && semi.records[0].column == 6,
+          "missing semicolon recorded at the inserted token");
+
+    // Formatting off: records only, repeated words are not re-interned
+    Analyzer quiet(trie, sym, logger);
+    quiet.setFormatIssues(false);
+    quiet.processLine("int mian() {", 1);
+    size_t names = quiet.issueNames().size();
+    auto r2 = quiet.processLine("int mian() {", 2);
+    check(r2.issues.empty() && !r2.records.empty(), "no messages formatted when formatting is off");
+    check(quiet.issueNames().size() == names, "repeated words reuse their interned ids");
+
+    // End-of-file bracket issues: text by default, records (line 0) for a sink when formatting is off
+    vector<string> open = {"int main() {", "  foo(1"};
+    vector<string> fileIssues;
+    Analyzer loud(trie, sym, logger);
+    loud.processFile(open, fileIssues);
+    check(fileIssues == vector<string>{"missing ')' at end of file", "inserted missing closing '}' at end of file"},
+          "end-of-file issues formatted by default");
+    vector<Issue> sink;
+    vector<string> none;
+    quiet.setIssueSink(&sink);
+    quiet.processFile(open, none);
+    quiet.setIssueSink(nullptr);
+    bool eof = none.empty() && sink.size() >= 2;
+    if (eof){
+        const Issue &paren = sink[sink.size() - 2], &brace = sink.back();
+        eof = paren.code == IssueCode::EOF_MISSING_PAREN && paren.line == 0 && brace.code == IssueCode::EOF_BRACE_INSERTED
+              && quiet.formatIssue(brace) == fileIssues[1];
+    }
+    check(eof, "end-of-file issues go to the sink as records when formatting is off");
+
+    cout << "\nTotal Failures: " << failures << endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,210 @@
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Json.h"
+#include "LspServer.h"
+#include "Utf8.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static string request(int id, const string &method, const string &params){
+    return "{\"jsonrpc\":\"2.0\",\"id\":" + to_string(id) + ",\"method\":\"" + method + "\",\"params\":" + params + "}";
+}
+
+static string notification(const string &method, const string &params){
+    return "{\"jsonrpc\":\"2.0\",\"method\":\"" + method + "\",\"params\":" + params + "}";
+}
+
+static string quoted(const string &s){
+    string out;
+    JsonValue::quote(out, s);
+    return out;
+}
+
+static string openParams(const string &uri, const string &text){
+    return "{\"textDocument\":{\"uri\":" + quoted(uri) + ",\"languageId\":\"cpp\",\"version\":1,\"text\":" + quoted(text) + "}}";
+}
+
+static string changeParams(const string &uri, int version, size_t l0, size_t c0, size_t l1, size_t c1, const string &text){
+    return "{\"textDocument\":{\"uri\":" + quoted(uri) + ",\"version\":" + to_string(version) + "},\"contentChanges\":[{\"range\":"
+           "{\"start\":{\"line\":" + to_string(l0) + ",\"character\":" + to_string(c0) + "},\"end\":{\"line\":" + to_string(l1)
+           + ",\"character\":" + to_string(c1) + "}},\"text\":" + quoted(text) + "}]}";
+}
+
+// Protocol handling through LspServer::handle, plus the JSON and UTF-16
+// helpers it is built on; one run over framed stdio-style input at the end.
+int main(){
+    int failures = 0;
+    auto check = [&](bool ok, const string &name){
+        cout << (ok ? "[PASS] " : "[FAIL] ") << name << "\n";
+        if (!ok) ++failures;
+    };
+
+    // JSON
+    {
+        JsonValue v;
+        string err;
+        bool ok = JsonValue::parse(R"({"a":[1,2.5,true,null],"s":"x\"é😀","o":{}})", v, &err);
+        check(ok && v["a"].size() == 4 && v["a"][1].asNumber() == 2.5 && v["a"][2].asBool() && v["a"][3].isNull(), "JSON arrays and scalars parse");
+        check(v["s"].asString() == "x\"\xC3\xA9\xF0\x9F\x98\x80", "JSON escapes and surrogate pairs decode to UTF-8");
+        check(v["missing"]["deeper"].isNull() && v["o"].isObject(), "missing members read as null");
+        check(JsonValue::object().set("k", JsonValue::array().push(1).push("t\n")).dump() == R"({"k":[1,"t\n"]})", "JSON builds and dumps");
+        check(!JsonValue::parse("{\"a\":1,}", v, &err) && !err.empty(), "malformed JSON is rejected");
+        check(!JsonValue::parse(string(1000, '['), v), "deep nesting is rejected");
+    }
+
+    // UTF-16 columns
+    {
+        string s = "a\xC3\xA9\xF0\x9F\x98\x80z"; // a, e-acute (1 unit), emoji (2 units), z
+        check(utf16Length(s.data(), s.size()) == 5, "UTF-16 length counts surrogate pairs");
+        check(utf16ToByteOffset(s.data(), s.size(), 2) == 3 && utf16ToByteOffset(s.data(), s.size(), 4) == 7
+              && utf16ToByteOffset(s.data(), s.size(), 99) == s.size(), "UTF-16 offsets map to byte offsets");
+    }
+
+    // Text edits
+    {
+        vector<string> lines;
+        LspServer::splitText("one\r\ntwo\n", lines);
+        check(lines == vector<string>{"one", "two", ""}, "text splits on LF and CRLF");
+        LspServer::applyEdit(lines, 0, 1, 1, 2, "X\nY");
+        check(lines == vector<string>{"oX", "Yo", ""}, "multi-line range replaced");
+        LspServer::applyEdit(lines, 1, 2, 1, 2, "\n\nnew");
+        check(lines == vector<string>{"oX", "Yo", "", "new", ""}, "insertion splits a line");
+        LspServer::applyEdit(lines, 0, 2, 3, 3, "");
+        check(lines == vector<string>{"oX", ""}, "deletion joins lines");
+        vector<string> wide = {"\xC3\xA9" "ab"};
+        LspServer::applyEdit(wide, 0, 1, 0, 2, "Q");
+        check(wide == vector<string>{"\xC3\xA9Qb"}, "edit columns are UTF-16 units");
+    }
+
+    LspServer server;
+    vector<string> out;
+    JsonValue msg;
+
+    server.handle(request(1, "textDocument/codeAction", "{}"), out);
+    check(out.size() == 1 && JsonValue::parse(out[0], msg) && msg["error"]["code"].asInt() == -32002, "requests before initialize fail");
+
+    out.clear();
+    server.handle(request(2, "initialize", "{\"capabilities\":{}}"), out);
+    check(out.size() == 1 && JsonValue::parse(out[0], msg) && msg["id"].asInt() == 2
+          && msg["result"]["capabilities"]["textDocumentSync"]["change"].asInt() == 2
+          && msg["result"]["capabilities"].has("codeActionProvider"), "initialize announces incremental sync and code actions");
+    out.clear();
+    server.handle(notification("initialized", "{}"), out);
+    check(out.empty(), "initialized needs no answer");
+
+    const string uri = "file:///tmp/sample.cpp";
+    string text = "#include <iostream>\nusing namespace std;\nint main() {\n    int x=5\n    cout << x;\n    return 0;\n}\n";
+    out.clear();
+    server.handle(notification("textDocument/didOpen", openParams(uri, text)), out);
+    bool published = out.size() == 1 && JsonValue::parse(out[0], msg) && msg["method"].asString() == "textDocument/publishDiagnostics";
+    check(published && msg["params"]["uri"].asString() == uri, "didOpen publishes diagnostics");
+    bool line3 = false;
+    for (auto &d : msg["params"]["diagnostics"].elements()){
+        if (d["range"]["start"]["line"].asInt() == 3 && d["source"].asString() == "intellifix" && !d["message"].asString().empty()) line3 = true;
+    }
+    check(line3, "missing semicolon reported on line 3 (0-based)");
+
+    out.clear();
+    server.handle(request(3, "textDocument/codeAction",
+                          "{\"textDocument\":{\"uri\":" + quoted(uri) + "},\"range\":{\"start\":{\"line\":3,\"character\":0},\"end\":{\"line\":3,\"character\":0}},\"context\":{\"diagnostics\":[]}}"), out);
+    bool quickfix = false, fixAll = false;
+    if (out.size() == 1 && JsonValue::parse(out[0], msg)){
+        for (auto &a : msg["result"].elements()){
+            const JsonValue &edits = a["edit"]["changes"][uri];
+            if (a["kind"].asString() == "quickfix" && edits.size() == 1 && edits[0]["newText"].asString() == "    int x=5;"
+                && edits[0]["range"]["start"]["line"].asInt() == 3) quickfix = true;
+            if (a["kind"].asString() == "source.fixAll" && edits.size() >= 1) fixAll = true;
+        }
+    }
+    check(quickfix, "code action replaces the line with its correction");
+    check(fixAll, "fix-all code action offered");
+
+    // Typing the semicolon clears the issue
+    out.clear();
+    server.handle(notification("textDocument/didChange", changeParams(uri, 2, 3, 11, 3, 11, ";")), out);
+    const vector<string> *doc = server.documentLines(uri);
+    check(doc && (*doc)[3] == "    int x=5;", "incremental change applied");
+    line3 = false;
+    if (out.size() == 1 && JsonValue::parse(out[0], msg)){
+        for (auto &d : msg["params"]["diagnostics"].elements()) if (d["range"]["start"]["line"].asInt() == 3) line3 = true;
+        check(msg["params"]["version"].asInt() == 2, "diagnostics carry the document version");
+    }
+    check(!line3, "fixed line no longer reported");
+
+    // A keystroke in a large file re-runs only nearby lines
+    {
+        const string big = "file:///tmp/big.cpp";
+        string body = "#include <iostream>\nusing namespace std;\n";
+        const size_t functions = 1000;
+        for (size_t f=0; f<functions; ++f){
+            body += "int f" + to_string(f) + "(int a) {\n    int b = a + 1;\n    if (b > 3) {\n        b = b * 2;\n    }\n"
+                    "    for (int i = 0; i < b; i++) {\n        a += i;\n    }\n    return a;\n}\n";
+        }
+        out.clear();
+        server.handle(notification("textDocument/didOpen", openParams(big, body)), out);
+        size_t lines = server.documentLines(big)->size();
+        check(lines > 10000, "large document opened (" + to_string(lines) + " lines)");
+        size_t target = lines / 2 + 1;
+        double worst = 0;
+        size_t maxRerun = 0;
+        for (int k=0; k<20; ++k){
+            out.clear();
+            auto t0 = chrono::steady_clock::now();
+            server.handle(notification("textDocument/didChange", changeParams(big, 2 + k, target, 4, target, 4, "x")), out);
+            double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+            worst = max(worst, ms);
+            maxRerun = max(maxRerun, server.lastRerun());
+        }
+        cout << "keystroke on " << lines << " lines: worst " << worst << " ms\n";
+        check(maxRerun < 50, "a keystroke re-runs only a few lines (" + to_string(maxRerun) + ")");
+        check(worst < 100, "keystroke diagnostics are fast");
+    }
+
+    out.clear();
+    server.handle(notification("textDocument/didClose", "{\"textDocument\":{\"uri\":" + quoted(uri) + "}}"), out);
+    check(!server.documentLines(uri) && out.size() == 1 && JsonValue::parse(out[0], msg)
+          && msg["params"]["diagnostics"].size() == 0, "didClose clears diagnostics");
+
+    out.clear();
+    server.handle(request(4, "workspace/symbol", "{}"), out);
+    check(out.size() == 1 && JsonValue::parse(out[0], msg) && msg["error"]["code"].asInt() == -32601, "unknown requests get MethodNotFound");
+    out.clear();
+    server.handle("{not json", out);
+    check(out.size() == 1 && JsonValue::parse(out[0], msg) && msg["error"]["code"].asInt() == -32700 && msg["id"].isNull(), "malformed messages get ParseError");
+
+    // Framed session over file descriptors
+    {
+        fs::path inPath = fs::temp_directory_path() / "intellifix_lsp_in.txt";
+        fs::path outPath = fs::temp_directory_path() / "intellifix_lsp_out.txt";
+        string framed;
+        for (const string &m : {request(1, "initialize", "{}"), notification("textDocument/didOpen", openParams(uri, "int x=5\n")),
+                                request(2, "shutdown", "null"), notification("exit", "null")}){
+            framed += "Content-Length: " + to_string(m.size()) + "\r\n\r\n" + m;
+        }
+        { ofstream(inPath, ios::binary) << framed; }
+        FILE *in = fopen(inPath.string().c_str(), "rb");
+        FILE *outFile = fopen(outPath.string().c_str(), "wb");
+        LspServer session;
+        int code = session.run(fileno(in), fileno(outFile));
+        fclose(in);
+        fclose(outFile);
+        ifstream back(outPath, ios::binary);
+        string got((istreambuf_iterator<char>(back)), istreambuf_iterator<char>());
+        size_t frames = 0;
+        for (size_t at = got.find("Content-Length: "); at != string::npos; at = got.find("Content-Length: ", at + 1)) ++frames;
+        check(code == 0 && session.exitRequested(), "shutdown then exit ends the session with status 0");
+        check(frames == 3 && got.find("publishDiagnostics") != string::npos, "replies are framed with Content-Length");
+        fs::remove(inPath);
+        fs::remove(outPath);
+    }
+
+    cout << "\nTotal Failures: " << failures << "\n";
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,69 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Trie.h"
+#include "SymbolTable.h"
+#include "Utils.h"
+#include "Logger.h"
+
+using namespace std;
+
+// processFile must produce byte-identical output whether it runs serially or
+// splits the file across worker threads.
+static vector<string> makeFile(size_t n){
+    static const char *lines[] = {
+        "#inclde<iostreem", "using namespacestd", "int main() {", "intx=5;",
+        "for(i =0, i< 7;i+ +){", "cout< \"abdulhadi", "cin> caravg", "floot caravg;",
+        "}", "if (x) { y = 'ab'; }", "    retun 0;", "while(a) {", "  ) ] }", "cot << a < b",
+        "// comment {", "string s = \"{\";", "vector<int> v(3);", "",
+    };
+    const size_t k = sizeof(lines) / sizeof(lines[0]);
+    vector<string> out;
+    unsigned long long st = 12345;
+    for (size_t i=0; i<n; ++i){
+        st = st * 6364136223846793005ULL + 1442695040888963407ULL;
+        out.push_back(lines[(st >> 33) % k]);
+    }
+    return out;
+}
+
+int main(){
+    Trie trie; SymbolTable sym; Logger logger;
+    int failures = 0;
+    auto check = [&](bool ok, const string &name){
+        cout << (ok ? "[PASS] " : "[FAIL] ") << name << "\n";
+        if (!ok) ++failures;
+    };
+
+    auto input = makeFile(20000);
+
+    Analyzer serial(trie, sym, logger);
+    serial.setThreads(1);
+    vector<string> serialIssues;
+    auto t0 = chrono::steady_clock::now();
+    auto serialOut = serial.processFile(input, serialIssues);
+    auto t1 = chrono::steady_clock::now();
+
+    Analyzer parallel(trie, sym, logger);
+    parallel.setThreads(4);
+    vector<string> parallelIssues;
+    auto parallelOut = parallel.processFile(input, parallelIssues);
+    auto t2 = chrono::steady_clock::now();
+
+    check(serialOut == parallelOut, "parallel output identical to serial (" + to_string(serialOut.size()) + " lines)");
+    check(serialIssues == parallelIssues, "file issues identical");
+    check(serial.getUnclosedBrackets() == parallel.getUnclosedBrackets(), "final bracket state identical");
+
+    // Running the same analyzer again starts from a clean brace state
+    vector<string> againIssues;
+    auto again = parallel.processFile(input, againIssues);
+    check(again == serialOut && againIssues == serialIssues, "second parallel run identical");
+
+    cerr << "serial " << chrono::duration<double, milli>(t1 - t0).count() << " ms, 4 threads "
+         << chrono::duration<double, milli>(t2 - t1).count() << " ms\n";
+
+    cout << "\nTotal Failures: " << failures << endl;
+    return failures == 0 ? 0 : 1;
+}
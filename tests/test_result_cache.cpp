@@ -0,0 +1,127 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Trie.h"
+#include "Batch.h"
+#include "ResultCache.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// A rerun over unchanged files must come entirely from the cache and give the
+// same results; edits, other pass settings and eviction must force a miss.
+static vector<string> readLines(const string &path){
+    ifstream in(path);
+    vector<string> lines;
+    string s;
+    while (std::getline(in, s)) lines.push_back(s);
+    return lines;
+}
+
+int main(){
+    int failures = 0;
+    auto check = [&](bool ok, const string &name){
+        cout << (ok ? "[PASS] " : "[FAIL] ") << name << "\n";
+        if (!ok) ++failures;
+    };
+
+    fs::path root = fs::temp_directory_path() / "intellifix_cache_test";
+    fs::remove_all(root);
+    fs::create_directories(root / "src");
+    const vector<vector<string>> sources = {
+        {"#inclde<iostreem", "int main() {", "intx=5;", "cout< \"abdulhadi"},
+        {"for(i =0, i< 7;i+ +){", "cin> caravg", "floot caravg;", "}"},
+        {"while(a) {", "    retun 0;", "  ) ] }"},
+    };
+    for (size_t i=0; i<sources.size(); ++i){
+        ofstream out(root / "src" / ("f" + to_string(i) + ".cpp"));
+        for (auto &l : sources[i]) out << l << "\n";
+    }
+    auto files = BatchRunner::collect({(root / "src").string()});
+    string cacheDir = (root / "cache").string();
+
+    Trie trie;
+    auto runOnce = [&](const string &passes, bool harvest = false){
+        BatchRunner batch(trie);
+        batch.setThreads(2);
+        batch.setOutputDir((root / "out").string());
+        batch.setCacheDir(cacheDir);
+        batch.setPasses(passes);
+        batch.setHarvestDeclarations(harvest);
+        auto results = batch.run(files);
+        cout << "  " << batch.cache()->stats() << "\n";
+        return results;
+    };
+    auto cachedCount = [](const vector<BatchFileResult> &rs){
+        size_t n = 0;
+        for (auto &r : rs) n += r.cached;
+        return n;
+    };
+
+    auto first = runOnce("");
+    vector<vector<string>> outputs;
+    for (auto &r : first) outputs.push_back(readLines(r.output));
+    check(cachedCount(first) == 0, "cold run misses");
+
+    auto second = runOnce("");
+    bool same = second.size() == first.size();
+    for (size_t i=0; same && i<second.size(); ++i){
+        same = second[i].ok && second[i].issues == first[i].issues && second[i].issueCount == first[i].issueCount
+            && second[i].changedLines == first[i].changedLines && readLines(second[i].output) == outputs[i];
+    }
+    check(cachedCount(second) == files.size(), "warm run is served from the cache");
+    check(same, "cached results equal fresh results");
+
+    { ofstream out(files[1], ios::app); out << "retun 1;\n"; }
+    auto third = runOnce("");
+    check(cachedCount(third) == files.size() - 1 && !third[1].cached, "edited file misses");
+    check(cachedCount(runOnce("fixForLoop=off")) == 0, "different passes miss");
+    check(cachedCount(runOnce("", true)) == 0, "two-pass mode misses one-pass results");
+
+    // Eviction keeps the newest entries within the byte limit
+    {
+        ResultCache cache(cacheDir, 0);
+        size_t removed = cache.evict();
+        check(removed > 0 && cache.stats().find("0 entries (0 bytes)") != string::npos, "evict enforces the size limit");
+        ResultCache::Entry e;
+        ResultCache::Source src{5, ResultCache::checksum("a\n\nb\n")};
+        check(!cache.lookup(1, src, e), "evicted entries miss");
+        e.fixed = {"a", "", "b"}; e.issues = {"line 1: x"}; e.issueCount = 2; e.changedLines = 1;
+        ResultCache::Entry back;
+        check(cache.store(42, src, e) && cache.lookup(42, src, back) && back.fixed == e.fixed && back.issues == e.issues
+              && back.issueCount == 2 && back.changedLines == 1, "entry round-trips (empty lines included)");
+        // Same key from another input (a key collision): a miss, never that input's result
+        ResultCache::Source other{5, ResultCache::checksum("a\n\nc\n")}, longer{6, src.check};
+        check(!cache.lookup(42, other, back) && !cache.lookup(42, longer, back) && cache.lookup(42, src, back),
+              "entry for a different input is a miss");
+    }
+
+    // Damaged entries are misses and are removed; interrupted stores are cleaned up
+    {
+        ResultCache cache(cacheDir);
+        fs::path huge = fs::path(cacheDir) / "0000000000000007.res";
+        fs::path cut = fs::path(cacheDir) / "0000000000000008.res";
+        { ofstream(huge, ios::binary) << "IFXC2\n0 0 18446744073709551615 4000000000000 1 1\nx\n"; }
+        { ofstream(cut, ios::binary) << "IFXC2\n0 0 3 0 0 0\na\n"; }
+        ResultCache::Entry e;
+        ResultCache::Source src;
+        check(!cache.lookup(7, src, e) && !fs::exists(huge), "counts larger than the file are a miss, entry removed");
+        check(!cache.lookup(8, src, e) && !fs::exists(cut), "truncated entry is a miss, entry removed");
+
+        fs::path stale = fs::path(cacheDir) / "0000000000000009.res.0.tmp";
+        fs::path fresh = fs::path(cacheDir) / "000000000000000a.res.1.tmp";
+        { ofstream(stale) << "partial"; }
+        { ofstream(fresh) << "partial"; }
+        fs::last_write_time(stale, fs::file_time_type::clock::now() - chrono::hours(2));
+        cache.evict();
+        check(!fs::exists(stale) && fs::exists(fresh), "evict deletes stale temporary files, keeps recent ones");
+    }
+
+    fs::remove_all(root);
+    cout << "\nTotal Failures: " << failures << endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,64 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Trie.h"
+#include "SymbolTable.h"
+#include "Utils.h"
+#include "Logger.h"
+
+using namespace std;
+
+// processStream must write exactly what processFile returns, across block
+// boundaries and with the end-of-file '}' tail, serially and in parallel.
+static vector<string> makeFile(size_t n){
+    static const char *lines[] = {
+        "#inclde<iostreem", "int main() {", "intx=5;", "cout< \"abdulhadi", "cin> caravg",
+        "for(i =0, i< 7;i+ +){", "}", "if (x) { y = 'ab'; }", "    retun 0;", "while(a) {", "  ) ] }", "",
+    };
+    const size_t k = sizeof(lines) / sizeof(lines[0]);
+    vector<string> out;
+    unsigned long long st = 777;
+    for (size_t i=0; i<n; ++i){
+        st = st * 6364136223846793005ULL + 1442695040888963407ULL;
+        out.push_back(lines[(st >> 33) % k]);
+    }
+    out.push_back("int tail() {"); // leave a brace open for finalizeFile
+    return out;
+}
+
+int main(){
+    Trie trie; SymbolTable sym; Logger logger;
+    int failures = 0;
+    auto check = [&](bool ok, const string &name){
+        cout << (ok ? "[PASS] " : "[FAIL] ") << name << "\n";
+        if (!ok) ++failures;
+    };
+
+    for (size_t n : {size_t(0), size_t(10), Analyzer::kStreamBlockLines * 2 + 17}){
+        auto input = makeFile(n);
+        string text;
+        for (auto &l : input) text += l + "\n";
+
+        Analyzer ref(trie, sym, logger);
+        ref.setThreads(1);
+        vector<string> refIssues;
+        string expected;
+        for (auto &l : ref.processFile(input, refIssues)) expected += l + "\n";
+
+        for (unsigned threads : {1u, 4u}){
+            Analyzer an(trie, sym, logger);
+            an.setThreads(threads);
+            istringstream in(text);
+            ostringstream out;
+            vector<string> issues;
+            size_t count = an.processStream(in, out, issues);
+            check(count == input.size() && out.str() == expected && issues == refIssues,
+                  to_string(input.size()) + " lines, threads=" + to_string(threads) + ": stream output matches processFile");
+        }
+    }
+
+    cout << "\nTotal Failures: " << failures << endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Trie.h"
+#include "SymbolTable.h"
+#include "Utils.h"
+#include "Logger.h"
+
+using namespace std;
+
+// Names declared in a visible scope must not be "corrected" to dictionary words,
+// names whose scope has closed are treated like any other word again, and the
+// parallel path must resolve scopes exactly like the serial one.
+int main(){
+    Trie trie; SymbolTable sym; Logger logger;
+    int failures = 0;
+    auto check = [&](bool ok, const string &name){
+        cout << (ok ? "[PASS] " : "[FAIL] ") << name << "\n";
+        if (!ok) ++failures;
+    };
+    auto fix = [&](const vector<string> &lines, unsigned threads = 1, bool harvest = false){
+        Analyzer an(trie, sym, logger);
+        an.setThreads(threads);
+        an.setHarvestDeclarations(harvest);
+        vector<string> issues;
+        return an.processFile(lines, issues);
+    };
+
+    // Baseline: an undeclared 'out' is read as a mistyped cout
+    check(fix({"out = 1;"})[0] == "cout << 1;", "undeclared 'out' becomes cout");
+
+    auto r = fix({"int out = 0;", "out = out + 1;"});
+    check(r[0] == "int out = 0;" && r[1] == "out = out + 1;", "declared 'out' is left alone");
+
+    r = fix({"void f() {", "int out = 1;", "}", "out = 2;"});
+    check(r[1] == "    int out = 1;" && r[3] == "cout << 2;", "name is forgotten when its block closes");
+
+    r = fix({"int a = 1, fo = 2;", "fo = 3;"});
+    check(r[0] == "int a = 1, fo = 2;" && r[1] == "fo = 3;", "comma-separated declarators are declared");
+    check(fix({"fo = 3;"})[0] == "for = 3;", "undeclared 'fo' still corrected");
+
+    r = fix({"vector<int> lsit;", "lsit.push_back(1);"});
+    check(r[1] == "lsit.push_back(1);", "template-typed variable is declared");
+
+    // Function names stay subject to correction
+    check(fix({"int mian() {", "}"})[0] == "int main() {", "function name is not protected");
+
+    // Serial and parallel runs must agree on a file long enough to be split
+    static const char *body[] = {
+        "int out = 0, fo = 1;", "out = fo + 1;", "void f() {", "    int lsit = 2;", "    lsit = out;",
+        "}", "lsit = 3;", "fo = out;", "{ int cot = 1; cot = 2; }", "cot = 4;",
+    };
+    vector<string> big;
+    for (size_t i=0; i<6000; ++i) big.push_back(body[i % (sizeof(body) / sizeof(body[0]))]);
+    auto serial = fix(big, 1), parallel = fix(big, 4);
+    check(serial == parallel, "parallel scope resolution matches serial");
+    check(serial[6] == "list = 3;" && serial[9] == "cout << 4;", "out-of-scope names corrected in a long file");
+
+    // Two-pass mode: names declared anywhere in the file skip the dictionary
+    check(fix({"vector<int> dp(5);", "dp[0] = 1;"})[0] == "vector<int> do(5);", "one pass: constructed variable looks like a typo");
+    check(fix({"vector<int> dp(5);", "dp[0] = 1;"}, 1, true)[0] == "vector<int> dp(5);", "two pass: constructed variable kept");
+    r = fix({"void run() {", "    helo(2);", "}", "void helo(int v) { }"}, 1, true);
+    check(r[0] == "void run() {" && r[1] == "    helo(2);", "two pass: functions defined later are known");
+    check(fix({"floot caravg = valeu;"}, 1, true)[0] == "float caravg = valeu;", "two pass: typos still corrected");
+    check(fix(big, 1, true) == fix(big, 4, true), "two pass: parallel harvest matches serial");
+
+    cout << "\nTotal Failures: " << failures << endl;
+    return failures == 0 ? 0 : 1;
+}
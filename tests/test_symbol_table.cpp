@@ -0,0 +1,58 @@
+#include <iostream>
+#include <string>
+
+#include "SymbolTable.h"
+
+using namespace std;
+
+// Shadowing, scope unwinding and table growth of the flat SymbolTable.
+int main(){
+    SymbolTable sym;
+    int failures = 0;
+    auto check = [&](bool ok, const string &name){
+        cout << (ok ? "[PASS] " : "[FAIL] ") << name << "\n";
+        if (!ok) ++failures;
+    };
+
+    sym.declare("x");
+    check(sym.isDeclared("x") && !sym.isDeclared("y"), "global declaration visible");
+
+    sym.enterScope();
+    sym.declare("y");
+    sym.declare("x"); // shadows the global x
+    sym.declare("y"); // same scope again: no second entry
+    check(sym.isDeclared("x") && sym.isDeclared("y") && sym.depth() == 2, "inner scope sees both names");
+    sym.enterScope();
+    check(sym.isDeclared("y"), "outer names visible from a nested scope");
+    sym.exitScope();
+    sym.exitScope();
+    check(sym.isDeclared("x") && !sym.isDeclared("y"), "exitScope unwinds only its own names");
+
+    sym.exitScope();
+    check(sym.depth() == 1 && sym.isDeclared("x"), "outermost scope is never popped");
+
+    // Enough names to force several rehashes; all must stay findable
+    sym.enterScope();
+    for (int i=0; i<5000; ++i) sym.declare("v" + to_string(i));
+    bool all = true;
+    for (int i=0; i<5000; ++i) all = all && sym.isDeclared("v" + to_string(i));
+    check(all && !sym.isDeclared("v5000"), "names survive table growth");
+    sym.exitScope();
+    check(!sym.isDeclared("v0") && !sym.isDeclared("v4999") && sym.isDeclared("x"), "grown scope unwinds");
+
+    sym.enterScope();
+    sym.declare("z");
+    sym.clear();
+    check(sym.depth() == 1 && !sym.isDeclared("x") && !sym.isDeclared("z"), "clear drops every declaration");
+    sym.declare("z");
+    check(sym.isDeclared("z"), "table usable after clear");
+
+    // "costarring" and "liquid" share a 32-bit FNV-1a hash
+    SymbolTable a, b;
+    a.declare("costarring");
+    b.declare("liquid");
+    check(a.fingerprint() != b.fingerprint(), "colliding names give different fingerprints");
+
+    cout << "\nTotal Failures: " << failures << endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,48 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Tokenizer.h"
+
+using namespace std;
+
+// Tokenizing into a reused buffer must give the same tokens as a fresh tokenize()
+// call, whether the previous line was longer or shorter.
+int main(){
+    Tokenizer tk;
+    vector<Token> buffer;
+    int failures = 0;
+
+    const vector<string> lines = {
+        "for(int i=0;i<n;i++){ cout << \"value: \" << arr[i] << endl; } // long line first",
+        "x;",
+        "",
+        "#include <iostream>",
+        "cout< \"abdulhadi",
+        "a->b :: c <= d && e || f != g",
+        "intx=5;",
+        "  \t  ",
+    };
+
+    for (const auto &line : lines){
+        auto fresh = tk.tokenize(line);
+        tk.tokenize(line, buffer);
+        bool ok = fresh.size() == buffer.size();
+        for (size_t i=0; ok && i<fresh.size(); ++i){
+            ok = fresh[i].type == buffer[i].type && fresh[i].value == buffer[i].value;
+        }
+        cout << (ok ? "[PASS] " : "[FAIL] ") << "\"" << line << "\" (" << buffer.size() << " tokens)\n";
+        if (!ok) ++failures;
+    }
+
+    // Steady state: after the longest line, the buffer capacity must not grow again
+    tk.tokenize(lines[0], buffer);
+    size_t cap = buffer.capacity();
+    for (const auto &line : lines) tk.tokenize(line, buffer);
+    bool stable = buffer.capacity() == cap;
+    cout << (stable ? "[PASS] " : "[FAIL] ") << "buffer capacity stable across lines\n";
+    if (!stable) ++failures;
+
+    cout << "\nTotal Failures: " << failures << endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,76 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Tokenizer.h"
+#include "TokenRewriter.h"
+
+using namespace std;
+
+// The gap buffer must behave exactly like a std::vector<Token> edited in place,
+// whatever the order of inserts, erases and reads.
+int main(){
+    int failures = 0;
+    auto check = [&](bool ok, const string &name){
+        cout << (ok ? "[PASS] " : "[FAIL] ") << name << "\n";
+        if (!ok) ++failures;
+    };
+    auto same = [](TokenRewriter &rw, const vector<Token> &ref){
+        if (rw.size() != ref.size()) return false;
+        for (size_t i=0; i<ref.size(); ++i){
+            if (rw[i].type != ref[i].type || rw[i].value != ref[i].value) return false;
+        }
+        return true;
+    };
+
+    Tokenizer tk;
+    vector<Token> tokens = tk.tokenize("intx=1; for(i=0 i<n i++) cout < x");
+    vector<Token> ref = tokens;
+    TokenRewriter rw;
+    rw.reset(tokens);
+    check(same(rw, ref), "reset takes over the tokens unchanged");
+
+    // Deterministic mix of edits at the front, middle, back and around the gap
+    unsigned long long st = 42;
+    bool ok = true;
+    for (int step=0; step<2000 && ok; ++step){
+        st = st * 6364136223846793005ULL + 1442695040888963407ULL;
+        size_t r = (size_t)(st >> 33);
+        size_t op = r % 4;
+        if (op == 3 && !ref.empty()){
+            size_t pos = (r / 4) % ref.size();
+            rw.erase(pos);
+            ref.erase(ref.begin() + pos);
+        } else if (op == 2){
+            Token t{TokType::SEPARATOR, ";" + to_string(step)};
+            rw.push_back(t);
+            ref.push_back(t);
+        } else {
+            size_t pos = (r / 4) % (ref.size() + 1);
+            Token t{TokType::IDENTIFIER, "t" + to_string(step)};
+            rw.insert(pos, t);
+            ref.insert(ref.begin() + pos, t);
+        }
+        if (!ref.empty()){
+            size_t k = (r / 7) % ref.size();
+            rw[k].value += "'";
+            ref[k].value += "'";
+        }
+        ok = same(rw, ref);
+    }
+    check(ok, "random edits match std::vector");
+
+    check(rw.flat().size() == ref.size() && same(rw, ref), "flat() closes the gap");
+    rw.insert(1, {TokType::WHITESPACE, " "});
+    ref.insert(ref.begin() + 1, {TokType::WHITESPACE, " "});
+    check(same(rw, ref), "still editable after flat()");
+
+    vector<Token> out;
+    rw.commit(out);
+    bool committed = out.size() == ref.size();
+    for (size_t i=0; committed && i<ref.size(); ++i) committed = out[i].value == ref[i].value;
+    check(committed && rw.empty(), "commit hands back the edited tokens");
+
+    cout << "\nTotal Failures: " << failures << endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,62 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Tokenizer.h"
+#include "TokenStore.h"
+
+using namespace std;
+
+// Edits must re-lex only the touched lines and leave the store equal to a
+// store freshly built from the edited text.
+int main(){
+    Tokenizer tk;
+    TokenStore store(tk);
+    int failures = 0;
+    auto check = [&](bool ok, const string &name){
+        cout << (ok ? "[PASS] " : "[FAIL] ") << name << "\n";
+        if (!ok) ++failures;
+    };
+    auto sameAsFresh = [&](){
+        TokenStore fresh(tk);
+        fresh.assign(store.lines());
+        if (fresh.lineCount() != store.lineCount()) return false;
+        for (size_t i=0; i<store.lineCount(); ++i){
+            const auto &a = store.tokens(i), &b = fresh.tokens(i);
+            if (a.size() != b.size()) return false;
+            for (size_t k=0; k<a.size(); ++k){
+                if (a.kinds[k] != b.kinds[k] || a.text(k) != b.text(k)) return false;
+            }
+        }
+        return true;
+    };
+
+    store.assign({"#include <iostream>", "int main(){", "    cout << x;", "    return 0;", "}"});
+    uint64_t v0 = store.version();
+
+    // Single-line edit: only line 2 is re-lexed
+    auto r = store.edit(2, 12, 2, 13, "y");
+    check(r.first == 2 && r.count == 1, "single-line edit re-lexes one line");
+    check(store.line(2) == "    cout << y;", "single-line edit text");
+    check(store.lineVersion(2) > v0 && store.lineVersion(1) == v0 && store.lineVersion(3) == v0, "untouched lines keep their version");
+    check(sameAsFresh(), "store matches fresh tokenization after single-line edit");
+
+    // Insert a new line (edit text contains a newline)
+    r = store.edit(2, 14, 2, 14, "\n    cin >> y;");
+    check(r.first == 2 && r.count == 2 && store.lineCount() == 6, "newline insert splits into two lines");
+    check(store.line(3) == "    cin >> y;" && store.line(4) == "    return 0;", "lines after insert shift down");
+    check(sameAsFresh(), "store matches fresh tokenization after insert");
+
+    // Multi-line delete joins lines
+    r = store.edit(1, 11, 3, 12, "");
+    check(store.lineCount() == 4 && store.line(1) == "int main(){;", "range delete joins lines");
+    check(sameAsFresh(), "store matches fresh tokenization after delete");
+
+    // Whole-line replacement
+    store.replaceLines(1, 1, {"int main() {", "    int x = 0;"});
+    check(store.lineCount() == 5 && store.line(2) == "    int x = 0;", "replaceLines splices lines");
+    check(sameAsFresh(), "store matches fresh tokenization after replaceLines");
+
+    cout << "\nTotal Failures: " << failures << endl;
+    return failures == 0 ? 0 : 1;
+}
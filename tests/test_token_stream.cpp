@@ -0,0 +1,61 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Tokenizer.h"
+#include "TokenStream.h"
+
+using namespace std;
+
+// The struct-of-arrays stream must describe exactly the tokens tokenize() returns,
+// and its summary must report the kinds/keywords present on the line.
+int main(){
+    Tokenizer tk;
+    TokenStream ts;
+    int failures = 0;
+    auto check = [&](bool ok, const string &name){
+        cout << (ok ? "[PASS] " : "[FAIL] ") << name << "\n";
+        if (!ok) ++failures;
+    };
+
+    const vector<string> lines = {
+        "for(int i=0;i<n;i++){ cout << \"x\"; } // done",
+        "  #include <iostream>",
+        "cin> caravg",
+        "",
+        "x = 'hello';",
+    };
+    for (const auto &line : lines){
+        auto toks = tk.tokenize(line);
+        tk.tokenize(line, ts);
+        bool ok = toks.size() == ts.size();
+        for (size_t i=0; ok && i<toks.size(); ++i){
+            ok = toks[i].type == ts.kind(i) && toks[i].value == ts.text(i);
+        }
+        check(ok, "spans match tokens: \"" + line + "\"");
+    }
+
+    tk.tokenize(lines[0], ts);
+    check(ts.summary.hasKeyword(tk.keywordId("for")), "summary has 'for'");
+    check(ts.summary.hasKeyword(tk.keywordId("cout")), "summary has 'cout'");
+    check(!ts.summary.hasKeyword(tk.keywordId("cin")), "summary lacks 'cin'");
+    check(ts.summary.hasKind(TokType::COMMENT), "summary has COMMENT");
+    check(!ts.summary.hasKind(TokType::PREPROCESSOR), "summary lacks PREPROCESSOR");
+
+    tk.tokenize(lines[1], ts);
+    size_t first = ts.nextMeaningful(0);
+    check(first == 1 && ts.kind(first) == TokType::PREPROCESSOR, "nextMeaningful skips leading whitespace");
+
+    tk.tokenize(lines[3], ts);
+    check(ts.size() == 0 && ts.nextMeaningful(0) == 0 && ts.summary.kinds == 0, "empty line has empty summary");
+
+    check(tk.keywordId("COUT") == tk.keywordId("cout") && tk.keywordId("caravg") == -1, "keywordId is case-insensitive");
+
+    vector<Token> out;
+    tk.tokenize(lines[2], ts);
+    ts.toTokens(out);
+    check(out.size() == ts.size() && out[0].value == "cin" && out[0].type == TokType::KEYWORD, "toTokens materializes tokens");
+
+    cout << "\nTotal Failures: " << failures << endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,55 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Tokenizer.h"
+#include "Utf8.h"
+
+using namespace std;
+
+// UTF-8 text must not be split into one UNKNOWN token per byte.
+int main(){
+    Tokenizer tk;
+    int failures = 0;
+    auto check = [&](bool ok, const string &name){
+        cout << (ok ? "[PASS] " : "[FAIL] ") << name << "\n";
+        if (!ok) ++failures;
+    };
+    auto dump = [](const vector<Token> &toks){
+        string s;
+        for (const auto &t : toks) s += "[" + t.value + "]";
+        return s;
+    };
+
+    // Identifier with accented letters is a single token
+    auto t1 = tk.tokenize("int café = 1;");
+    cout << "  " << dump(t1) << "\n";
+    check(t1.size() == 8 && t1[2].type == TokType::IDENTIFIER && t1[2].value == "café", "UTF-8 identifier is one token");
+
+    // Comment and string literal with multibyte text stay whole
+    auto t2 = tk.tokenize("cout << \"Grüße\"; // Привет мир");
+    check(t2.size() == 8 && t2[4].type == TokType::STRING_LITERAL && t2.back().type == TokType::COMMENT, "UTF-8 string and comment stay single tokens");
+
+    // Multibyte characters outside literals join the surrounding identifier
+    auto t3 = tk.tokenize("x\xF0\x9F\x98\x80y");
+    check(t3.size() == 1 && t3[0].value == "x\xF0\x9F\x98\x80y", "4-byte sequence joins identifier");
+
+    // Invalid bytes are grouped into one UNKNOWN token
+    auto t4 = tk.tokenize("a \xC0\xAF\xFF b");
+    check(t4.size() == 5 && t4[2].type == TokType::UNKNOWN && t4[2].value == "\xC0\xAF\xFF", "invalid bytes grouped into one UNKNOWN token");
+
+    // Validator edge cases
+    check(utf8SequenceLength("\xC3\xA9", 2) == 2, "2-byte sequence");
+    check(utf8SequenceLength("\xE0\x80\x80", 3) == 0, "overlong 3-byte rejected");
+    check(utf8SequenceLength("\xED\xA0\x80", 3) == 0, "surrogate rejected");
+    check(utf8SequenceLength("\xF4\x90\x80\x80", 4) == 0, "above U+10FFFF rejected");
+    check(utf8SequenceLength("\xE2\x82", 2) == 0, "truncated sequence rejected");
+
+    string longAscii(1000, 'a');
+    check(utf8IsAscii(longAscii.data(), longAscii.size()), "long ASCII run detected");
+    longAscii[997] = '\xC3';
+    check(!utf8IsAscii(longAscii.data(), longAscii.size()), "high byte in tail detected");
+
+    cout << "\nTotal Failures: " << failures << endl;
+    return failures == 0 ? 0 : 1;
+}